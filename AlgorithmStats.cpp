@@ -0,0 +1,90 @@
+// Mail: tzohary1234@gmail.com
+// Author: Tzohar Lary
+
+#include "AlgorithmStats.hpp"
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+
+using namespace std;
+using namespace ariel;
+
+// the innermost running scope of this thread, and the last scope that finished on it
+static thread_local ScopedStats* innermost = nullptr;
+static thread_local AlgorithmStats lastFinished;
+// counters of work done outside of any scope, so ARIEL_COUNT always has a place to go
+static thread_local AlgorithmStats outsideScopes;
+
+static mutex registryMutex;
+static map<string, AggregateStats> registry;
+
+AlgorithmStats& AlgorithmStats::operator+=(const AlgorithmStats& other) {
+    edgesScanned += other.edgesScanned;
+    relaxations += other.relaxations;
+    passes += other.passes;
+    verticesVisited += other.verticesVisited;
+    queuePushes += other.queuePushes;
+    cacheHits += other.cacheHits;
+    elapsedUs += other.elapsedUs;
+    return *this;
+}
+
+ScopedStats::ScopedStats(const char* name) : name(name), outer(innermost) {
+    innermost = this;
+    start = chrono::steady_clock::now();
+}
+
+ScopedStats::~ScopedStats() {
+    stats.elapsedUs = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+    StatsRegistry::finish(*this);
+}
+
+void StatsRegistry::finish(ScopedStats& scope) {
+    innermost = scope.outer;
+    if (scope.name == nullptr) {
+        return; // a TaskStats, its owner takes the counters
+    }
+    if (scope.outer != nullptr) {
+        // the outer call did this work too, but its own timer already covers the time
+        double outerElapsed = scope.outer->stats.elapsedUs;
+        scope.outer->stats += scope.stats;
+        scope.outer->stats.elapsedUs = outerElapsed;
+    }
+    lastFinished = scope.stats;
+    lock_guard<mutex> lock(registryMutex);
+    AggregateStats& entry = registry[scope.name];
+    ++entry.calls;
+    entry.total += scope.stats;
+}
+
+AlgorithmStats& StatsRegistry::current() {
+    return innermost != nullptr ? innermost->stats : outsideScopes;
+}
+
+AlgorithmStats StatsRegistry::last() {
+    return lastFinished;
+}
+
+map<string, AggregateStats> StatsRegistry::aggregate() {
+    lock_guard<mutex> lock(registryMutex);
+    return registry;
+}
+
+void StatsRegistry::clear() {
+    lock_guard<mutex> lock(registryMutex);
+    registry.clear();
+}
+
+void StatsRegistry::print(ostream& out) {
+    map<string, AggregateStats> snapshot = aggregate();
+    out << left << setw(28) << "algorithm" << right << setw(10) << "calls" << setw(14) << "edges"
+        << setw(14) << "relaxations" << setw(10) << "passes" << setw(12) << "visited"
+        << setw(12) << "pushes" << setw(10) << "hits" << setw(14) << "total_us" << endl;
+    for (const auto& entry : snapshot) {
+        const AlgorithmStats& t = entry.second.total;
+        out << left << setw(28) << entry.first << right << setw(10) << entry.second.calls
+            << setw(14) << t.edgesScanned << setw(14) << t.relaxations << setw(10) << t.passes
+            << setw(12) << t.verticesVisited << setw(12) << t.queuePushes << setw(10) << t.cacheHits
+            << setw(14) << fixed << setprecision(1) << t.elapsedUs << endl;
+    }
+}
@@ -0,0 +1,91 @@
+// Mail: tzohary1234@gmail.com
+// Author: Tzohar Lary
+
+
+#ifndef ALGORITHMSTATS_HPP
+#define ALGORITHMSTATS_HPP
+
+#include <chrono>
+#include <map>
+#include <ostream>
+#include <string>
+
+namespace ariel {
+    // Counters of the work done by one call of an algorithm.
+    struct AlgorithmStats {
+        unsigned long long edgesScanned = 0;
+        unsigned long long relaxations = 0;
+        unsigned long long passes = 0;
+        unsigned long long verticesVisited = 0;
+        unsigned long long queuePushes = 0;
+        unsigned long long cacheHits = 0;
+        double elapsedUs = 0;
+
+        AlgorithmStats& operator+=(const AlgorithmStats& other);
+    };
+
+    // All the calls of one algorithm added together.
+    struct AggregateStats {
+        unsigned long long calls = 0;
+        AlgorithmStats total;
+    };
+
+    // Measures one call: it starts the timer and collects the counters until it goes out of scope.
+    // Scopes nest, the counters of an inner call are added to the call around it as well.
+    class ScopedStats {
+        private:
+            const char* name;
+            AlgorithmStats stats;
+            ScopedStats* outer;
+            std::chrono::steady_clock::time_point start;
+
+            friend class StatsRegistry;
+            friend class TaskStats;
+
+        public:
+            explicit ScopedStats(const char* name);
+            ~ScopedStats();
+            ScopedStats(const ScopedStats&) = delete;
+            ScopedStats& operator=(const ScopedStats&) = delete;
+    };
+
+    // Collects the counters of one task of the thread pool. The task runs on a worker for a call
+    // that runs on another thread, so while it is alive the work counted on the worker (also by the
+    // calls inside the task) goes here instead of to the scopes of the worker, and TaskGroup adds
+    // it to the call that waits for the task. It is not a call itself, so it isn't registered.
+    class TaskStats {
+        private:
+            ScopedStats scope;
+
+        public:
+            TaskStats() : scope(nullptr) {}
+            const AlgorithmStats& collected() const { return scope.stats; }
+    };
+
+    // The counters of the running call on this thread, the last finished call on this thread,
+    // and the aggregate of every call on every thread, by algorithm name.
+    class StatsRegistry {
+        public:
+            static AlgorithmStats& current();
+            static AlgorithmStats last();
+            static std::map<std::string, AggregateStats> aggregate();
+            static void clear();
+            static void print(std::ostream& out);
+
+        private:
+            static void finish(ScopedStats& scope);
+            friend class ScopedStats;
+    };
+}
+
+// The algorithms count their work with these macros. Without ARIEL_ENABLE_STATS they are
+// empty, so a normal build pays nothing for them.
+#ifdef ARIEL_ENABLE_STATS
+#define ARIEL_STATS_SCOPE(name) ariel::ScopedStats arielStatsScope(name)
+#define ARIEL_COUNT(field, amount) (ariel::StatsRegistry::current().field += (amount))
+#else
+#define ARIEL_STATS_SCOPE(name) ((void)0)
+#define ARIEL_COUNT(field, amount) ((void)0)
+#endif
+
+#endif // ALGORITHMSTATS_HPP
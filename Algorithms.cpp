@@ -3,20 +3,63 @@
 
 
 #include "Algorithms.hpp"
+#include "AlgorithmStats.hpp"
+#include "ThreadPool.hpp"
+#include "Workspace.hpp"
+#include "EpochArray.hpp"
+#include "SimdKernels.hpp"
+#include "LandmarkIndex.hpp"
 #include <queue>
+#include <map>
+#include <functional>
 #include <limits>
 #include <vector>
 #include <algorithm>
 #include <iostream>
 #include <stack>
 #include <sstream> 
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+#include <cmath>
 
 
 using namespace std;
 using namespace ariel;
 
-string Algorithms::shortestPath(const Graph& g, int start, int end) {
-    
+// Number of start vertices in one task of the thread pool, so that every task scans about
+// 64K matrix cells and small graphs run on the calling thread only.
+static size_t parallelGrain(size_t n) {
+    return max<size_t>(1, 65536 / (n * n + 1));
+}
+
+// The path from the root of prev to end, in order from the root.
+// prev is a vector<int> or an EpochArray<int>.
+template <typename Parents>
+static void tracePath(const Parents& prev, int end, vector<int>& path) {
+    path.clear();
+    for (int at = end; at != -1; at = prev[at]) {
+        path.push_back(at);
+    }
+    reverse(path.begin(), path.end());
+}
+
+// The vertices of a path as "0->2->1", or "-1" for an empty path (no path found).
+// Every path string of the library is made here.
+static string joinPath(const vector<int>& path) {
+    if (path.empty()) {
+        return "-1";
+    }
+    string pathStr;
+    for (size_t k = 0; k < path.size(); k++) {
+        pathStr += (k == 0 ? "" : "->") + to_string(path[k]);
+    }
+    return pathStr;
+}
+
+string Algorithms::shortestPath(const Graph& g, int start, int end, ShortestPathEngine engine) {
+    ARIEL_STATS_SCOPE("shortestPath");
+
     // Check if the graph is empty using the isEmpty method of the graph object.
     // If it is empty, throw an invalid_argument exception with a message indicating the graph is empty.
     if (g.isEmpty()) {
@@ -37,58 +80,137 @@ string Algorithms::shortestPath(const Graph& g, int start, int end) {
         throw invalid_argument("Start or end node does not exist");
     }
 
+    // the scratch arrays come from the workspace of this thread, so repeated queries don't allocate
+    Workspace ws;
+    vector<int>& dist = ws.take<int>(0, 0);
+    vector<int>& prev = ws.take<int>(0, 0);
+    singleSourcePaths(g, start, isDirected(g), engine, dist, prev);
+
+    // If the distance to the end node is still infinity, no path exists
+    if (dist[end] == numeric_limits<int>::max()) {
+        return "-1"; // No path found
+    }
+
+    return pathToString(prev, end);
+}
+
+string Algorithms::shortestPath(const Graph& g, int start, int end, const LandmarkIndex& landmarks) {
+    ARIEL_STATS_SCOPE("shortestPath");
+    if (g.isEmpty()) {
+        throw invalid_argument("The graph is empty");
+    }
+    int n = g.getAdjacencyMatrix().size();
+    if (start < 0 || start >= n || end < 0 || end >= n) {
+        throw invalid_argument("Start or end node does not exist");
+    }
+    return joinPath(landmarks.query(g, start, end).path);
+}
+
+void Algorithms::singleSourcePaths(const Graph& g, int start, bool directed, ShortestPathEngine engine,
+                                   vector<int>& dist, vector<int>& prev) {
+    int n = g.getAdjacencyMatrix().size();
+
     // Initialize distances and predecessors
-    vector<int> dist(n, numeric_limits<int>::max());
-    vector<int> prev(n, -1);
+    dist.assign(n, numeric_limits<int>::max());
+    prev.assign(n, -1);
 
     // Set the distance to the start node as 0
     dist[start] = 0;
 
-    // Relax edges up to n-1 times
-    for (int i = 0; i < n - 1; i++) {
-    relax(g, dist, prev);
+    // Relax edges up to n-1 times, or in topological passes until nothing changes
+    if (engine == ShortestPathEngine::Dijkstra) {
+        dijkstra(g, start, dist, prev);
+        return; // no negative edges, so no negative cycle
+    } else if (engine == ShortestPathEngine::DeltaStepping) {
+        deltaStepping(g, start, dist, prev);
+        return;
+    } else if (engine == ShortestPathEngine::GoldbergRadzik) {
+        goldbergRadzik(g, dist, prev, directed);
+    } else {
+        for (int i = 0; i < n - 1; i++) {
+        relax(g, dist, prev, directed);
+        }
     }
     
-    // Check for negative-weight cycles
-    if (hasNegativeCycle(g, dist)) {
+    // Check for negative-weight cycles, there can be one only when some edge is negative
+    if (g.negativeEdgeCount() > 0 && hasNegativeCycle(g, dist)) {
         // if a negative cycle is detected, so we can't find the shortest path 
         // because we cannot find a reliable shortest path.
         throw runtime_error("Graph contains a negative-weight cycle");
     }
+}
 
-    // If the distance to the end node is still infinity, no path exists
-    if (dist[end] == numeric_limits<int>::max()) {
-        return "-1"; // No path found
+vector<string> Algorithms::shortestPaths(const Graph& g, const vector<pair<int, int>>& queries,
+                                         ShortestPathEngine engine) {
+    ARIEL_STATS_SCOPE("shortestPaths");
+    if (g.isEmpty()) {
+        throw invalid_argument("The graph is empty");
     }
+    int n = g.getAdjacencyMatrix().size();
 
-        // Reconstruct path from end to start using the predecessor array
-    vector<int> path;
-    for (int at = end; at != -1; at = prev[at]) {
-        path.push_back(at);
+    // Validate the whole batch before doing any work, and group the queries by their start node
+    vector<int> order(queries.size());
+    for (size_t q = 0; q < queries.size(); ++q) {
+        int start = queries[q].first;
+        int end = queries[q].second;
+        if (start < 0 || start >= n || end < 0 || end >= n) {
+            throw invalid_argument("Start or end node does not exist");
+        }
+        order[q] = q;
     }
-    reverse(path.begin(), path.end()); // Reverse to get the correct order from start to end
-
-    // Convert path to string format
-    string pathStr = "";
-    for (size_t i = 0; i < path.size(); ++i) {
-        pathStr += to_string(path[i]);
-        if (i < path.size() - 1) {
-            pathStr += "->"; // Add arrow between nodes
+    stable_sort(order.begin(), order.end(), [&queries](int a, int b) {
+        return queries[a].first < queries[b].first;
+    });
+    vector<size_t> groupBegin; // where every start node begins in order
+    for (size_t k = 0; k < order.size(); ++k) {
+        if (k == 0 || queries[order[k]].first != queries[order[k - 1]].first) {
+            groupBegin.push_back(k);
         }
     }
-    return pathStr; // Return the path as a string
+    groupBegin.push_back(order.size());
+
+    // One tree for every distinct start node, the start nodes run on the thread pool, as many
+    // in one task as make it worth one. The graph is checked for direction only once for the
+    // whole batch.
+    bool directed = isDirected(g);
+    vector<string> answers(queries.size());
+    ThreadPool::instance().parallelFor(0, groupBegin.size() - 1, parallelGrain(n), [&](size_t lo, size_t hi) {
+        Workspace ws;
+        vector<int>& dist = ws.take<int>(0, 0);
+        vector<int>& prev = ws.take<int>(0, 0);
+        for (size_t group = lo; group < hi; ++group) {
+            int start = queries[order[groupBegin[group]]].first;
+            singleSourcePaths(g, start, directed, engine, dist, prev);
+            for (size_t k = groupBegin[group]; k < groupBegin[group + 1]; ++k) {
+                int end = queries[order[k]].second;
+                answers[order[k]] = dist[end] == numeric_limits<int>::max() ? "-1" : pathToString(prev, end);
+            }
+        }
+    });
+    return answers;
+}
+
+string Algorithms::pathToString(const vector<int>& prev, int end) {
+    // Reconstruct path from end to start using the predecessor array, then format it
+    Workspace ws;
+    vector<int>& path = ws.take<int>(0, 0);
+    tracePath(prev, end, path);
+    return joinPath(path);
 }
 
 bool Algorithms::isContainsCycle(const Graph& g) {
+    ARIEL_STATS_SCOPE("isContainsCycle");
     // The purpose of the method is to check whether the graph g has a cycle.
     // It returns true if there is a cycle and false otherwise.
 
     int n = g.getAdjacencyMatrix().size();
-    vector<bool> visited(n, false); // Array to store visited nodes
-    vector<int> parent(n, -1); // Array to store parent nodes for find back edge
+    Workspace ws;
+    VisitedSet& visited = ws.reuse<VisitedSet>(); // Set to store visited nodes
+    visited.prepare(n);
+    vector<int>& parent = ws.take<int>(n, -1); // Array to store parent nodes for find back edge
 
     for (int i = 0; i < n; ++i) {
-        if (!visited[i]) {
+        if (!visited.contains(i)) {
             // if the dfsCycleCheck method returns true, then the graph has a cycle.
             if (dfsCycleCheck(g, i, visited, parent)) {
                 return true;
@@ -100,6 +222,7 @@ bool Algorithms::isContainsCycle(const Graph& g) {
 }
 
 std::string Algorithms::isBipartite(const Graph& g) {
+    ARIEL_STATS_SCOPE("isBipartite");
     //BFS succeeds in coloring a two-color graph if and only if the graph is bipartite.
 
     // Check if the graph is empty using the isEmpty method of the graph object.
@@ -111,23 +234,33 @@ std::string Algorithms::isBipartite(const Graph& g) {
         return "this graph is empty";
     }
 
+    // The searches start from the vertices in increasing order
+    Workspace ws;
+    std::vector<int>& order = ws.take<int>(n, 0);
+    for (int v = 0; v < n; ++v) {
+        order[v] = v;
+    }
+    std::vector<int>& colors = ws.take<int>(n, -1);
+    if (!bipartiteColors(g, order, colors)) {
+        return "0";  // Early odd cycle detection
+    }
+    return bipartiteToString(colors);
+}
+
+bool Algorithms::bipartiteColors(const Graph& g, const std::vector<int>& order, std::vector<int>& colors) {
+    int n = g.getAdjacencyMatrix().size();
     // Use -1 for uncolored, 0 and 1 for the two colors
-    std::vector<int> colors(n, -1);
-    for (int start = 0; start < n; ++start) {
+    colors.assign(n, -1);
+    for (int k = 0; k < n; ++k) {
+        int start = order[k];
         // Perform BFS from each uncolored vertex
         if (colors[start] == -1) {
-        bool hasEdges = false;
-        // Check if the current vertex has any edges
-            for (int i = 0; i < n; ++i) {
-                if (g.getAdjacencyMatrix()[start][i]) {
-                    hasEdges = true;
-                    break;
-                }
-            }
-        
+        // Check if the current vertex has any edges, the graph keeps the degrees
+        bool hasEdges = g.outDegree(start) > 0;
+
             if (!hasEdges) {
                 // Handle the case where there are no edges.
-                colors[start] = start % 2;  // Assign color based on vertex index
+                colors[start] = k % 2;  // Assign color based on its place in the order
 
             }
             else {
@@ -135,6 +268,7 @@ std::string Algorithms::isBipartite(const Graph& g) {
             std::queue<int> q;
             //  Start BFS from the current vertex
             q.push(start);
+            ARIEL_COUNT(queuePushes, 1);
             colors[start] = 0;  // Assign initial color
 
             // Perform BFS traversal
@@ -142,30 +276,32 @@ std::string Algorithms::isBipartite(const Graph& g) {
                 //  Get the front of the queue  
                 int node = q.front();
                 q.pop();
+                ARIEL_COUNT(verticesVisited, 1);
 
                 //  Traverse all adjacent vertices of the current vertex
-                for (int i = 0; i < n; ++i) {
-                    //  Check if there is an edge from the current vertex to vertex i
-                    if (g.getAdjacencyMatrix()[node][i]) {  
-                        
-                        if (colors[i] == -1) {
-                            colors[i] = 1 - colors[node];  // Assign opposite color
-                            q.push(i);
-                        } else if (colors[i] == colors[node]) {
-                            return "0";  // Early odd cycle detection
-                        }
+                for (const Neighbor& e : g.neighbors(node)) {
+                    int i = e.vertex;
+                    ARIEL_COUNT(edgesScanned, 1);
+                    if (colors[i] == -1) {
+                        colors[i] = 1 - colors[node];  // Assign opposite color
+                        q.push(i);
+                        ARIEL_COUNT(queuePushes, 1);
+                    } else if (colors[i] == colors[node]) {
+                        return false;  // Early odd cycle detection
                     }
-                    
                 }
             }
             }
         }
     }
+    return true;
+}
 
+std::string Algorithms::bipartiteToString(const std::vector<int>& colors) {
     // Construct result string if the graph is bipartite
     std::string setA_str = "A={";
     std::string setB_str = "B={";
-    for (int i = 0; i < n; ++i) {
+    for (size_t i = 0; i < colors.size(); ++i) {
         if (colors[i] == 0) {
             setA_str += std::to_string(i);
             setA_str += ", ";
@@ -191,28 +327,50 @@ std::string Algorithms::isBipartite(const Graph& g) {
     return "The graph is bipartite: " + setA_str + ", " + setB_str;
 }
 
-bool Algorithms::isDirected(const Graph& g) {
-    const auto& matrix = g.getAdjacencyMatrix();
-    size_t n = matrix.size();
-    for (size_t i = 0; i < n; ++i) {
-        for (size_t j = i + 1; j < n; ++j) {
-            if (matrix[i][j] != matrix[j][i]) {
-                return true;
-            }
+bool Algorithms::isBipartiteStream(size_t n, const vector<pair<int, int>>& edges) {
+    ARIEL_STATS_SCOPE("isBipartiteStream");
+    // Every edge puts its two ends on opposite sides of a parity union-find,
+    // so the whole check is near-linear in the number of edges and needs no matrix.
+    DisjointSet sides(n);
+    for (const auto& edge : edges) {
+        ARIEL_COUNT(edgesScanned, 1);
+        if (!sides.addEdge(edge.first, edge.second)) {
+            return false; // odd cycle found, no need to read the rest of the stream
         }
     }
+    return true;
+}
 
-    return false;
+bool Algorithms::isDirected(const Graph& g) {
+    ARIEL_STATS_SCOPE("isDirected");
+    // The graph counts the cells that differ from their mirror while it is built and updated
+    // (comparing the matrix in tiles with SimdKernels::symmetricTile), so no scan is needed here.
+    ARIEL_COUNT(cacheHits, 1);
+    return g.isDirected();
 }
 
 string Algorithms::negativeCycle(const Graph& originalGraph) {
+    return negativeCycle(originalGraph, 2);
+}
+
+string Algorithms::negativeCycle(const Graph& originalGraph, int undirectedSource) {
+    ARIEL_STATS_SCOPE("negativeCycle");
     int n = originalGraph.getAdjacencyMatrix().size();
-    vector<int> baseDist(n, numeric_limits<int>::max()); // base distances array
     string result;
 
+    // Without negative edges there is no negative cycle, so the Bellman-Ford runs are skipped
+    if (originalGraph.negativeEdgeCount() == 0) {
+        ARIEL_COUNT(cacheHits, 1);
+        if (!isDirected(originalGraph)) {
+            return "No negative cycle detected in undirected graph.\nNo negative cycle detected in directed graph.";
+        }
+        return "The graph cannot be interpreted as undirected.\nNo negative cycle detected in the graph.";
+    }
+
     if (!isDirected(originalGraph)) {
-            vector<int> dist = baseDist; // create a copy of the base distances
-            dist[2] = 0; // define the current node as the source
+            Workspace ws;
+            vector<int>& dist = ws.take<int>(n, numeric_limits<int>::max()); // base distances array
+            dist[undirectedSource] = 0; // define the current node as the source
             bool negativeCycle = bellmanFord(originalGraph, dist);
             if (negativeCycle) {
                 result = "Negative cycle detected in undirected graph.\nNegative cycle detected in directed graph.";
@@ -228,15 +386,23 @@ string Algorithms::negativeCycle(const Graph& originalGraph) {
         
     } else {
         result += "The graph cannot be interpreted as undirected.\n";
-        for (int i = 0; i < n; ++i) {
-            vector<int> dist = baseDist; // create a copy of the base distances
-            dist[i] = 0; // define the current node as the source
-            bool negativeCycle = bellmanFord(originalGraph, dist);
-            if (negativeCycle) {
-                result += "Negative cycle detected in the graph.";
-                // cout << result << endl;
-                return result;
+        // The sources are independent, so they run on the thread pool.
+        // Once one of them finds a cycle the others are skipped.
+        atomic<bool> found(false);
+        ThreadPool::instance().parallelFor(0, n, parallelGrain(n), [&](size_t lo, size_t hi) {
+            Workspace ws;
+            vector<int>& dist = ws.take<int>(0, 0);
+            for (size_t i = lo; i < hi && !found; ++i) {
+                dist.assign(n, numeric_limits<int>::max()); // base distances array
+                dist[i] = 0; // define the current node as the source
+                if (bellmanFord(originalGraph, dist)) {
+                    found = true;
+                }
             }
+        });
+        if (found) {
+            result += "Negative cycle detected in the graph.";
+            return result;
         }
         result += "No negative cycle detected in the graph.";
     }
@@ -245,14 +411,21 @@ string Algorithms::negativeCycle(const Graph& originalGraph) {
     return result;
 }
 
-bool Algorithms::bellmanFord(const Graph& g, vector<int>& dist) {
+bool Algorithms::bellmanFord(const Graph& g, vector<int>& dist, ShortestPathEngine engine) {
+    ARIEL_STATS_SCOPE("bellmanFord");
     int n = g.getAdjacencyMatrix().size();
-    vector<int> parent(n, -1);
+    Workspace ws;
+    vector<int>& parent = ws.take<int>(n, -1);
     
-    // Relax edges up to n-1 times
-    for (int i = 0; i < n - 1; ++i) {
-        // cout << "starting relax number " << i << endl;
-        relax(g, dist, parent);
+    bool directed = isDirected(g);
+    if (engine == ShortestPathEngine::GoldbergRadzik) {
+        goldbergRadzik(g, dist, parent, directed);
+    } else {
+        // Relax edges up to n-1 times
+        for (int i = 0; i < n - 1; ++i) {
+            // cout << "starting relax number " << i << endl;
+            relax(g, dist, parent, directed);
+        }
     }
 
     // Check for negative cycles
@@ -260,28 +433,83 @@ bool Algorithms::bellmanFord(const Graph& g, vector<int>& dist) {
 }
 
 bool Algorithms::hasNegativeEdge(const Graph& g, vector<int>& dist) {
-    auto adjMatrix = g.getAdjacencyMatrix();  // retrieve the adjacency matrix of the graph
-    for (int i = 0; i < adjMatrix.size(); ++i) {
-        for (int j = 0; j < adjMatrix[i].size(); ++j) {
-            if (adjMatrix[i][j] < 0) {
-                return true; // found a negative edge in the graph return true
-            }
+    ARIEL_STATS_SCOPE("hasNegativeEdge");
+    // the graph keeps the number of negative edges updated
+    ARIEL_COUNT(cacheHits, 1);
+    return g.negativeEdgeCount() > 0;
+}
+
+GraphStats Algorithms::graphStats(const Graph& g, bool parallel) {
+    ARIEL_STATS_SCOPE("graphStats");
+    const vector<vector<int>>& adj = g.getAdjacencyMatrix();
+    size_t n = adj.size();
+    GraphStats stats;
+    stats.vertices = n;
+    stats.outDegree.assign(n, 0);
+    stats.inDegree.assign(n, 0);
+    int minWeight = numeric_limits<int>::max();
+    int maxWeight = numeric_limits<int>::min();
+    mutex merge;
+
+    // Scans the rows [lo, hi) into its own in-degree counters and adds everything to stats at the end
+    auto scanRows = [&](size_t lo, size_t hi) {
+        Workspace ws;
+        vector<uint32_t>& inDegree = ws.take<uint32_t>(n, 0);
+        size_t edges = 0;
+        size_t negativeEdges = 0;
+        size_t selfLoops = 0;
+        int low = numeric_limits<int>::max();
+        int high = numeric_limits<int>::min();
+        for (size_t u = lo; u < hi; ++u) {
+            RowStats row = SimdKernels::rowStats(adj[u].data(), n, inDegree.data());
+            stats.outDegree[u] = row.edges; // every row has one writer
+            edges += row.edges;
+            negativeEdges += row.negativeEdges;
+            selfLoops += adj[u][u] != 0;
+            low = min(low, row.minWeight);
+            high = max(high, row.maxWeight);
+        }
+        ARIEL_COUNT(verticesVisited, hi - lo);
+        ARIEL_COUNT(edgesScanned, edges);
+        lock_guard<mutex> lock(merge);
+        stats.edges += edges;
+        stats.negativeEdges += negativeEdges;
+        stats.selfLoops += selfLoops;
+        minWeight = min(minWeight, low);
+        maxWeight = max(maxWeight, high);
+        for (size_t v = 0; v < n; ++v) {
+            stats.inDegree[v] += inDegree[v];
         }
+    };
+
+    if (parallel) {
+        // A few pieces per worker, each big enough to pay for its own in-degree counters
+        size_t pieces = 4 * ThreadPool::instance().size();
+        size_t grain = max<size_t>((n + pieces - 1) / pieces, 65536 / (n + 1));
+        ThreadPool::instance().parallelFor(0, n, max<size_t>(grain, 1), scanRows);
+    } else {
+        scanRows(0, n);
     }
-    return false; // no negative edges found in the graph return false
+
+    if (stats.edges > 0) {
+        stats.minWeight = minWeight;
+        stats.maxWeight = maxWeight;
+    }
+    return stats;
 }
     
 bool Algorithms::hasNegativeCycle(const Graph& g, const vector<int>& dist) {
     int n = g.getAdjacencyMatrix().size();
-    const vector<vector<int>>& adj = g.getAdjacencyMatrix();
-    vector<bool> calculated(n, false); // New array to keep track of calculated nodes
+    Workspace ws;
+    vector<bool>& calculated = ws.take<bool>(n, false); // New array to keep track of calculated nodes
     for (int u = 0; u < n; ++u) {
         // Skip nodes that are not connected to the main component
         if (dist[u] == numeric_limits<int>::max()) continue;
-        const vector<int>& neighbors = adj[u];
-        for (int v = 0; v < n-1; ++v) {
-            // Check if there is an edge and if the edge can further decrease the distance
-            if (neighbors[v] != 0 && dist[u] != numeric_limits<int>::max() && dist[v] > dist[u] + neighbors[v] && !calculated[v]) {
+        for (const Neighbor& e : g.neighbors(u)) {
+            int v = e.vertex;
+            if (v >= n - 1) break; // the neighbors are sorted, and the last vertex is not checked
+            // Check if the edge can further decrease the distance
+            if (dist[v] > dist[u] + e.weight && !calculated[v]) {
                 return true;
             }
         }
@@ -291,30 +519,438 @@ bool Algorithms::hasNegativeCycle(const Graph& g, const vector<int>& dist) {
 }
 
 void Algorithms::relax(const Graph& g, vector<int>& dist, vector<int>& parent) {
+    relax(g, dist, parent, isDirected(g));
+}
+
+void Algorithms::relax(const Graph& g, vector<int>& dist, vector<int>& parent, bool directed) {
     const vector<vector<int>>& adj = g.getAdjacencyMatrix();
     int n = adj.size();
+    ARIEL_COUNT(passes, 1);
     for (int u = 0; u < n; ++u) {
         if (dist[u] == numeric_limits<int>::max()) continue;
-        for (int v = 0; v < n; ++v) {
-            if (adj[u][v] != 0 ) {
-                if (isDirected(g)) {
-                    if (dist[v] > dist[u] + adj[u][v]) {
-                        dist[v] = dist[u] + adj[u][v];
-                        parent[v] = u;
+        ARIEL_COUNT(verticesVisited, 1);
+        const vector<int>& row = adj[u];
+        NeighborRange edges = g.neighbors(u);
+        if (row[u] >= 0 && edges.size() * 8 >= (size_t)n) {
+            // A dense row goes through the vectorized kernel all at once. In an undirected graph
+            // the edge back to the parent of u is skipped.
+            ARIEL_COUNT(edgesScanned, SimdKernels::countNonZero(row.data(), n));
+            size_t relaxed = SimdKernels::relaxRow(row.data(), dist[u], u, directed ? -1 : parent[u],
+                                                   dist.data(), parent.data(), n);
+            ARIEL_COUNT(relaxations, relaxed);
+            (void)relaxed; // only read by the counters
+            continue;
+        }
+        // A sparse row walks its edges only. A negative self loop changes dist[u] in the middle
+        // of the row, so it also stays edge by edge. The sums saturate the same as in the kernel.
+        for (const Neighbor& e : edges) {
+            int v = e.vertex;
+            ARIEL_COUNT(edgesScanned, 1);
+            int candidate = SimdKernels::saturatingAdd(dist[u], e.weight);
+            if (directed) {
+                if (dist[v] > candidate) {
+                    dist[v] = candidate;
+                    parent[v] = u;
+                    ARIEL_COUNT(relaxations, 1);
+                }
+            } else {
+                if (dist[v] > candidate && parent[u] != v) {
+                    dist[v] = candidate;
+                    parent[v] = u;
+                    ARIEL_COUNT(relaxations, 1);
+                }
+            }
+        }
+    }
+    
+}
+
+// Returns true if the edge u->v with weight w can decrease dist[v].
+// In an undirected graph we don't go back on the edge we came from, the same as relax does.
+static bool canImprove(const vector<int>& dist, const vector<int>& parent, bool directed, int u, int v, int w) {
+    if (w == 0 || dist[u] == numeric_limits<int>::max()) {
+        return false;
+    }
+    if (!directed && parent[u] == v) {
+        return false;
+    }
+    return dist[v] > SimdKernels::saturatingAdd(dist[u], w);
+}
+
+// Returns true if some edge of u can decrease the distance of its target
+static bool hasAdmissibleEdge(const Graph& g, const vector<int>& dist, const vector<int>& parent, bool directed, int u) {
+    for (const Neighbor& e : g.neighbors(u)) {
+        if (canImprove(dist, parent, directed, u, e.vertex, e.weight)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Collects, in topological order, the labeled vertices with an admissible edge (an edge that can
+// decrease the distance of its target) and every vertex reachable from them.
+// A vertex below such a vertex may get a smaller distance in this pass, even one that is still
+// infinite now, so all its edges are followed and not only the ones admissible before the pass.
+// Every vertex whose distance can change is then after all the vertices that can change it,
+// and on a DAG one pass gives the final distances.
+// The DFS is iterative so long chains don't overflow the call stack.
+// The visited set is given by the caller and cleared here, so the passes don't zero it again.
+static void topologicalScan(const Graph& g, const vector<int>& dist, const vector<int>& parent,
+                            const vector<bool>& labeled, bool directed, VisitedSet& visited, vector<int>& order) {
+    int n = g.getAdjacencyMatrix().size();
+    Workspace ws;
+    visited.clear();
+    vector<pair<int, int>>& stack = ws.take<pair<int, int>>(0, make_pair(0, 0)); // (vertex, position of the next neighbor to check)
+    order.clear();
+
+    for (int root = 0; root < n; ++root) {
+        if (!labeled[root] || visited.contains(root) || !hasAdmissibleEdge(g, dist, parent, directed, root)) continue;
+        visited.mark(root);
+        stack.push_back(make_pair(root, 0));
+        ARIEL_COUNT(verticesVisited, 1);
+        while (!stack.empty()) {
+            int u = stack.back().first;
+            int& next = stack.back().second;
+            NeighborRange edges = g.neighbors(u);
+            int degree = edges.size();
+            while (next < degree && visited.contains(edges[next].vertex)) {
+                ++next;
+            }
+            if (next == degree) {
+                // all the edges of u are done, so u is finished
+                order.push_back(u);
+                stack.pop_back();
+            } else {
+                int v = edges[next++].vertex;
+                visited.mark(v);
+                stack.push_back(make_pair(v, 0));
+                ARIEL_COUNT(verticesVisited, 1);
+            }
+        }
+    }
+    // finish order reversed is the topological order
+    reverse(order.begin(), order.end());
+}
+
+int Algorithms::goldbergRadzik(const Graph& g, vector<int>& dist, vector<int>& parent) {
+    return goldbergRadzik(g, dist, parent, isDirected(g));
+}
+
+int Algorithms::goldbergRadzik(const Graph& g, vector<int>& dist, vector<int>& parent, bool directed) {
+    ARIEL_STATS_SCOPE("goldbergRadzik");
+    // Goldberg-Radzik: every pass scans the vertices whose distance changed and that can improve
+    // a neighbor (and everything reachable from them) in topological order.
+    // On a DAG the first pass already gives the final distances, and the second scan finds
+    // nothing to start from.
+    int n = g.getAdjacencyMatrix().size();
+
+    // At the beginning every vertex with a known distance is labeled
+    Workspace ws;
+    vector<bool>& labeled = ws.take<bool>(n, false);
+    for (int u = 0; u < n; ++u) {
+        labeled[u] = dist[u] != numeric_limits<int>::max();
+    }
+
+    vector<int>& order = ws.take<int>(0, 0);
+    VisitedSet& visited = ws.reuse<VisitedSet>();
+    visited.prepare(n);
+    // Like Bellman-Ford, n-1 passes are enough when there is no negative cycle
+    int pass = 0;
+    for (; pass < n - 1; ++pass) {
+        topologicalScan(g, dist, parent, labeled, directed, visited, order);
+        if (order.empty()) {
+            break; // no vertex can be improved, we are done
+        }
+        ARIEL_COUNT(passes, 1);
+        fill(labeled.begin(), labeled.end(), false);
+        for (int u : order) {
+            for (const Neighbor& e : g.neighbors(u)) {
+                int v = e.vertex;
+                ARIEL_COUNT(edgesScanned, 1);
+                if (canImprove(dist, parent, directed, u, v, e.weight)) {
+                    dist[v] = SimdKernels::saturatingAdd(dist[u], e.weight);
+                    parent[v] = u;
+                    labeled[v] = true;
+                    ARIEL_COUNT(relaxations, 1);
+                }
+            }
+        }
+    }
+    return pass;
+}
+
+// BFS from source over the out-edges, or over the in-edges when reverse is set.
+// Returns true if it visits every vertex.
+static bool searchReachesAll(const Graph& g, int source, bool reverse) {
+    size_t n = g.getAdjacencyMatrix().size();
+    Workspace ws;
+    VisitedSet& visited = ws.reuse<VisitedSet>();
+    visited.prepare(n);
+    vector<int>& queue = ws.take<int>(0, 0);
+    visited.mark(source);
+    queue.push_back(source);
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int u = queue[head];
+        ARIEL_COUNT(verticesVisited, 1);
+        NeighborRange edges = reverse ? g.inNeighbors(u) : g.neighbors(u);
+        for (const Neighbor& e : edges) {
+            ARIEL_COUNT(edgesScanned, 1);
+            if (visited.visit(e.vertex)) {
+                queue.push_back(e.vertex);
+                ARIEL_COUNT(queuePushes, 1);
+            }
+        }
+    }
+    return queue.size() == n;
+}
+
+// Checks the arguments of the engines that need non negative weights
+static void checkNonNegative(const Graph& g, int start) {
+    int n = g.getAdjacencyMatrix().size();
+    if (start < 0 || start >= n) {
+        throw out_of_range("Start node does not exist");
+    }
+    if (g.negativeEdgeCount() > 0) {
+        throw invalid_argument("The graph has negative edges");
+    }
+}
+
+void Algorithms::dijkstra(const Graph& g, int start, vector<int>& dist, vector<int>& parent) {
+    ARIEL_STATS_SCOPE("dijkstra");
+    checkNonNegative(g, start);
+    int n = g.getAdjacencyMatrix().size();
+    dist.assign(n, numeric_limits<int>::max());
+    parent.assign(n, -1);
+
+    // Binary heap of (distance, vertex). A vertex can be in it several times,
+    // the entries with an old distance are skipped when they come out.
+    typedef pair<int, int> Entry;
+    Workspace ws;
+    vector<Entry>& heap = ws.take<Entry>(0, Entry(0, 0));
+    dist[start] = 0;
+    heap.push_back(Entry(0, start));
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end(), greater<Entry>());
+        Entry top = heap.back();
+        heap.pop_back();
+        int u = top.second;
+        if (top.first != dist[u]) continue;
+        ARIEL_COUNT(verticesVisited, 1);
+        for (const Neighbor& e : g.neighbors(u)) {
+            ARIEL_COUNT(edgesScanned, 1);
+            if (dist[u] + e.weight < dist[e.vertex]) {
+                dist[e.vertex] = dist[u] + e.weight;
+                parent[e.vertex] = u;
+                heap.push_back(Entry(dist[e.vertex], e.vertex));
+                push_heap(heap.begin(), heap.end(), greater<Entry>());
+                ARIEL_COUNT(relaxations, 1);
+                ARIEL_COUNT(queuePushes, 1);
+            }
+        }
+    }
+}
+
+int Algorithms::autoDelta(const Graph& g) {
+    // Meyer and Sanders: a bucket about as wide as the heaviest edge divided by the average
+    // degree keeps the buckets full enough to share out, without many vertices being relaxed
+    // again inside one bucket. Unit weights give buckets of one BFS level.
+    if (g.edgeCount() == 0) {
+        return 1;
+    }
+    int maxWeight = 1;
+    size_t n = g.getAdjacencyMatrix().size();
+    for (size_t u = 0; u < n; ++u) {
+        for (const Neighbor& e : g.neighbors(u)) {
+            maxWeight = max(maxWeight, e.weight);
+        }
+    }
+    double averageDegree = (double)g.edgeCount() / n;
+    return max(1, (int)(maxWeight / max(1.0, averageDegree)));
+}
+
+// A relaxation found by the parallel scan: dist[vertex] can become distance through from
+namespace {
+    struct Request {
+        int vertex;
+        int distance;
+        int from;
+    };
+}
+
+void Algorithms::deltaStepping(const Graph& g, int start, vector<int>& dist, vector<int>& parent, int delta) {
+    ARIEL_STATS_SCOPE("deltaStepping");
+    checkNonNegative(g, start);
+    if (delta <= 0) {
+        delta = autoDelta(g);
+    }
+    int n = g.getAdjacencyMatrix().size();
+    dist.assign(n, numeric_limits<int>::max());
+    parent.assign(n, -1);
+
+    // Bucket i holds the vertices with a distance in [i * delta, (i + 1) * delta). A vertex is not
+    // removed from its old bucket when its distance drops, it is skipped there instead.
+    map<int, vector<int>> buckets;
+    dist[start] = 0;
+    buckets[0].push_back(start);
+
+    Workspace ws;
+    vector<int>& frontier = ws.take<int>(0, 0);
+    vector<int>& settled = ws.take<int>(0, 0);  // the vertices of the current bucket, for the heavy edges
+    VisitedSet& inFrontier = ws.reuse<VisitedSet>();
+    inFrontier.prepare(n);
+    VisitedSet settledSet(n);
+    vector<vector<Request>> pieces;
+
+    // The edges of the vertices in list are scanned on the thread pool and every piece collects
+    // its requests; then they are applied in order on this thread, so the result doesn't depend
+    // on the scheduling. light selects the edges up to delta, otherwise the heavier ones.
+    auto relaxEdges = [&](const vector<int>& list, bool light) {
+        size_t grain = max<size_t>(64, list.size() / (4 * ThreadPool::instance().size()) + 1);
+        pieces.assign((list.size() + grain - 1) / grain, vector<Request>());
+        ThreadPool::instance().parallelFor(0, list.size(), grain, [&](size_t lo, size_t hi) {
+            vector<Request>& requests = pieces[lo / grain];
+            for (size_t k = lo; k < hi; ++k) {
+                int u = list[k];
+                for (const Neighbor& e : g.neighbors(u)) {
+                    if ((e.weight <= delta) == light && dist[u] + e.weight < dist[e.vertex]) {
+                        requests.push_back(Request{e.vertex, dist[u] + e.weight, u});
                     }
-                } else {
-                    if (dist[v] > dist[u] + adj[u][v] && parent[u] != v) {
-                        dist[v] = dist[u] + adj[u][v];
-                        parent[v] = u;
+                }
+            }
+        });
+        for (const vector<Request>& requests : pieces) {
+            for (const Request& r : requests) {
+                if (r.distance < dist[r.vertex]) {
+                    dist[r.vertex] = r.distance;
+                    parent[r.vertex] = r.from;
+                    buckets[r.distance / delta].push_back(r.vertex);
+                    ARIEL_COUNT(relaxations, 1);
+                }
+            }
+        }
+    };
+
+    while (!buckets.empty()) {
+        int index = buckets.begin()->first;
+        settled.clear();
+        settledSet.clear();
+        // Light edges can put vertices back into this bucket, so it is emptied again until it stays empty
+        while (!buckets[index].empty()) {
+            frontier.clear();
+            inFrontier.clear();
+            for (int v : buckets[index]) {
+                if (dist[v] / delta == index && inFrontier.visit(v)) {
+                    frontier.push_back(v);
+                    if (settledSet.visit(v)) {
+                        settled.push_back(v);
                     }
                 }
             }
+            buckets[index].clear();
+            ARIEL_COUNT(passes, 1);
+            ARIEL_COUNT(verticesVisited, frontier.size());
+            relaxEdges(frontier, true);
         }
+        buckets.erase(index);
+        // A heavy edge always leads to a later bucket, so it is relaxed once per vertex
+        relaxEdges(settled, false);
     }
-    
+}
+
+PathResult Algorithms::aStarSearch(const Graph& g, int start, int end, const function<double(int)>& heuristic) {
+    ARIEL_STATS_SCOPE("aStar");
+    checkNonNegative(g, start);
+    int n = g.getAdjacencyMatrix().size();
+    if (end < 0 || end >= n) {
+        throw out_of_range("End node does not exist");
+    }
+
+    // Dijkstra ordered by dist + heuristic, so the vertices in the direction of end come out first
+    // and the search stops when end comes out. With a heuristic that isn't consistent a vertex can
+    // come out again with a shorter distance, it is simply pushed again.
+    // The entries are (dist + heuristic, (dist, vertex)), the distance tells an entry pushed
+    // before dist[v] went down, which is skipped.
+    // dist and parent are EpochArrays, so a search that settles few vertices doesn't pay O(n)
+    // to reset them.
+    typedef pair<double, pair<int, int>> Entry;
+    Workspace ws;
+    EpochArray<int>& dist = ws.reuse<EpochArray<int>>();
+    EpochArray<int>& parent = ws.reuse<EpochArray<int>>();
+    dist.prepare(n, numeric_limits<int>::max());
+    parent.prepare(n, -1);
+    vector<Entry>& heap = ws.take<Entry>(0, Entry(0, make_pair(0, 0)));
+    PathResult result;
+    result.distance = numeric_limits<int>::max();
+    dist.set(start, 0);
+    heap.push_back(Entry(heuristic(start), make_pair(0, start)));
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end(), greater<Entry>());
+        Entry top = heap.back();
+        heap.pop_back();
+        int u = top.second.second;
+        if (top.second.first != dist[u]) continue;
+        result.settled++;
+        ARIEL_COUNT(verticesVisited, 1);
+        if (u == end) {
+            break;
+        }
+        for (const Neighbor& e : g.neighbors(u)) {
+            ARIEL_COUNT(edgesScanned, 1);
+            int candidate = dist[u] + e.weight;
+            if (candidate < dist[e.vertex]) {
+                dist.set(e.vertex, candidate);
+                parent.set(e.vertex, u);
+                heap.push_back(Entry(candidate + heuristic(e.vertex), make_pair(candidate, e.vertex)));
+                push_heap(heap.begin(), heap.end(), greater<Entry>());
+                ARIEL_COUNT(relaxations, 1);
+                ARIEL_COUNT(queuePushes, 1);
+            }
+        }
+    }
+
+    if (dist[end] != numeric_limits<int>::max()) {
+        result.distance = dist[end];
+        tracePath(parent, end, result.path);
+    }
+    return result;
+}
+
+string Algorithms::aStar(const Graph& g, int start, int end, const function<double(int)>& heuristic) {
+    return joinPath(aStarSearch(g, start, end, heuristic).path);
+}
+
+string Algorithms::aStar(const Graph& g, int start, int end, Heuristic kind, double scale) {
+    if (g.isEmpty()) {
+        throw invalid_argument("The graph is empty");
+    }
+    if (end < 0 || end >= (int)g.getAdjacencyMatrix().size()) {
+        throw out_of_range("End node does not exist");
+    }
+    return aStar(g, start, end, coordinateHeuristic(g.attribute("x"), g.attribute("y"), end, kind, scale));
+}
+
+function<double(int)> Algorithms::coordinateHeuristic(const vector<double>& x, const vector<double>& y,
+                                                      int end, Heuristic kind, double scale) {
+    if (x.size() != y.size() || end < 0 || end >= (int)x.size()) {
+        throw invalid_argument("The coordinates don't match the end node");
+    }
+    // the lambda keeps references, the arrays must live as long as the search
+    const vector<double>* xs = &x;
+    const vector<double>* ys = &y;
+    double ex = x[end];
+    double ey = y[end];
+    if (kind == Heuristic::Manhattan) {
+        return [xs, ys, ex, ey, scale](int v) {
+            return scale * (fabs((*xs)[v] - ex) + fabs((*ys)[v] - ey));
+        };
+    }
+    return [xs, ys, ex, ey, scale](int v) {
+        return scale * sqrt(((*xs)[v] - ex) * ((*xs)[v] - ex) + ((*ys)[v] - ey) * ((*ys)[v] - ey));
+    };
 }
 
 bool Algorithms::isConnected(const Graph& g) {
+    ARIEL_STATS_SCOPE("isConnected");
     // Check if the graph is empty
     if (g.isEmpty()) {
         throw invalid_argument("The graph is empty");
@@ -326,38 +962,184 @@ bool Algorithms::isConnected(const Graph& g) {
         throw invalid_argument("The graph is empty");
     }
 
-    // Iterate over all vertices to ensure every vertex can reach all other vertices
-    for (size_t startNode = 0; startNode < n; ++startNode) {
-        // Create a visited array to track visited vertices
-        vector<bool> visited(n, false);
+    // In an undirected graph every vertex reaches all the others exactly when there is one component.
+    // The first call builds the components of the graph, and from then on the changes keep them
+    // up to date, so the next calls are O(1).
+    if (!isDirected(g)) {
+        if (g.hasComponents()) {
+            ARIEL_COUNT(cacheHits, 1);
+        }
+        return g.componentCount() == 1;
+    }
+
+    // Every vertex must reach all the other vertices, which is the same as vertex 0 reaching
+    // every vertex and every vertex reaching 0: one search forward and one over the in-edges.
+    return searchReachesAll(g, 0, false) && searchReachesAll(g, 0, true);
+}
 
-        // Perform Depth-First Search (DFS) from the startNode
-        dfs(g, startNode, visited, n);
+// Bit-parallel BFS (MS-BFS) from up to 64 sources at once. Bit i of a vertex's word stands
+// for source i, so one scan of a vertex's edges moves all the searches that reached it in
+// the same level. onLevel(level, v, bits) is called when the sources in bits reach v.
+// If onLevel returns false the search stops.
+template <typename OnLevel>
+static void bitParallelBFS(const Graph& g, const int* sources, size_t count, OnLevel onLevel) {
+    size_t n = g.getAdjacencyMatrix().size();
+    Workspace ws;
+    vector<uint64_t>& seen = ws.take<uint64_t>(n, 0);   // sources that already reached v
+    vector<uint64_t>& visit = ws.take<uint64_t>(n, 0);  // sources that reached v in the current level
+    vector<uint64_t>& next = ws.take<uint64_t>(n, 0);   // sources that reach v in the next level
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t bit = uint64_t(1) << i;
+        seen[sources[i]] |= bit;
+        visit[sources[i]] |= bit;
+    }
+    for (size_t v = 0; v < n; ++v) {
+        if (visit[v] != 0 && !onLevel(0, v, visit[v])) {
+            return;
+        }
+    }
 
-        // Check if all vertices were visited from the startNode
-        for (bool nodeVisited : visited) {
-            if (!nodeVisited) {
-                return false; // If any vertex is not visited, the graph is not connected
+    bool active = true;
+    for (int level = 1; active; ++level) {
+        active = false;
+        for (size_t u = 0; u < n; ++u) {
+            if (visit[u] == 0) continue;
+            ARIEL_COUNT(verticesVisited, 1);
+            for (const Neighbor& e : g.neighbors(u)) {
+                next[e.vertex] |= visit[u];
+                ARIEL_COUNT(edgesScanned, 1);
+            }
+        }
+        for (size_t v = 0; v < n; ++v) {
+            uint64_t reached = next[v] & ~seen[v];
+            next[v] = 0;
+            visit[v] = reached;
+            if (reached != 0) {
+                seen[v] |= reached;
+                active = true;
+                if (!onLevel(level, v, reached)) {
+                    return;
+                }
             }
         }
     }
-    
-    // If all vertices can reach all other vertices, the graph is connected
-    return true;
 }
 
-void Algorithms::dfs(const Graph& g, size_t node, vector<bool>& visited, size_t n) {
-    visited[node] = true;
-    for (size_t i = 0; i < n; ++i) {
-        if (g.getAdjacencyMatrix()[node][i] != 0 && !visited[i]) {
-            dfs(g, i, visited,n);
+// Checks the start vertices of the multi source searches
+static void checkSources(const Graph& g, const vector<int>& sources) {
+    if (g.isEmpty()) {
+        throw invalid_argument("The graph is empty");
+    }
+    int n = g.getAdjacencyMatrix().size();
+    for (int s : sources) {
+        if (s < 0 || s >= n) {
+            throw invalid_argument("Start node does not exist");
         }
     }
 }
 
-bool Algorithms::dfsCycleCheck(const Graph& g, int v, vector<bool>& visited, vector<int>& parent) {
+vector<vector<int>> Algorithms::hopDistances(const Graph& g, const vector<int>& sources) {
+    ARIEL_STATS_SCOPE("hopDistances");
+    checkSources(g, sources);
     int n = g.getAdjacencyMatrix().size();
-    if (visited[v]) {
+
+    // -1 marks a vertex the source doesn't reach
+    vector<vector<int>> hops(sources.size(), vector<int>(n, -1));
+    size_t batches = (sources.size() + 63) / 64;
+    ThreadPool::instance().parallelFor(0, batches, 1, [&](size_t lo, size_t hi) {
+        for (size_t batch = lo; batch < hi; ++batch) {
+            size_t first = batch * 64;
+            size_t count = min<size_t>(64, sources.size() - first);
+            bitParallelBFS(g, &sources[first], count, [&](int level, size_t v, uint64_t bits) {
+                while (bits != 0) {
+                    int i = __builtin_ctzll(bits); // lowest set bit
+                    hops[first + i][v] = level;
+                    bits &= bits - 1;
+                }
+                return true;
+            });
+        }
+    });
+    return hops;
+}
+
+bool Algorithms::reachesAll(const Graph& g, const vector<int>& sources) {
+    ARIEL_STATS_SCOPE("reachesAll");
+    checkSources(g, sources);
+    size_t n = g.getAdjacencyMatrix().size();
+    size_t batches = (sources.size() + 63) / 64;
+    atomic<bool> missing(false);
+    ThreadPool::instance().parallelFor(0, batches, 1, [&](size_t lo, size_t hi) {
+        for (size_t batch = lo; batch < hi && !missing; ++batch) {
+            size_t first = batch * 64;
+            size_t count = min<size_t>(64, sources.size() - first);
+            uint64_t all = count == 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1;
+            // every vertex must be reached by all the sources of the batch
+            size_t complete = 0;
+            Workspace ws;
+            vector<uint64_t>& reachedBy = ws.take<uint64_t>(n, 0);
+            bitParallelBFS(g, &sources[first], count, [&](int, size_t v, uint64_t bits) {
+                reachedBy[v] |= bits;
+                if (reachedBy[v] == all) {
+                    ++complete;
+                }
+                return !missing.load();
+            });
+            if (complete != n) {
+                missing = true;
+            }
+        }
+    });
+    return !missing;
+}
+
+void Algorithms::dfs(const Graph& g, size_t node, VisitedSet& visited, size_t n) {
+    visited.mark(node);
+    ARIEL_COUNT(verticesVisited, 1);
+    for (const Neighbor& e : g.neighbors(node)) {
+        ARIEL_COUNT(edgesScanned, 1);
+        if (!visited.contains(e.vertex)) {
+            dfs(g, e.vertex, visited,n);
+        }
+    }
+}
+
+// Copies vector<bool> marks into a VisitedSet for the old signatures of dfs and dfsCycleCheck
+static void toVisitedSet(const vector<bool>& marks, VisitedSet& visited) {
+    visited.reset(marks.size());
+    for (size_t v = 0; v < marks.size(); ++v) {
+        if (marks[v]) {
+            visited.mark(v);
+        }
+    }
+}
+
+// Copies the marks of a VisitedSet back into vector<bool> marks
+static void fromVisitedSet(const VisitedSet& visited, vector<bool>& marks) {
+    for (size_t v = 0; v < marks.size(); ++v) {
+        marks[v] = visited.contains(v);
+    }
+}
+
+void Algorithms::dfs(const Graph& g, size_t node, vector<bool>& visited, size_t n) {
+    Workspace ws;
+    VisitedSet& marks = ws.reuse<VisitedSet>();
+    toVisitedSet(visited, marks);
+    dfs(g, node, marks, n);
+    fromVisitedSet(marks, visited);
+}
+
+bool Algorithms::dfsCycleCheck(const Graph& g, int v, vector<bool>& visited, vector<int>& parent) {
+    Workspace ws;
+    VisitedSet& marks = ws.reuse<VisitedSet>();
+    toVisitedSet(visited, marks);
+    bool cycle = dfsCycleCheck(g, v, marks, parent);
+    fromVisitedSet(marks, visited);
+    return cycle;
+}
+
+bool Algorithms::dfsCycleCheck(const Graph& g, int v, VisitedSet& visited, vector<int>& parent) {
+    if (visited.contains(v)) {
         // Check for back edge (directed cycle)
         if (parent[v] != -1 && g.getAdjacencyMatrix()[parent[v]][v] != 0) {
             return true;
@@ -369,23 +1151,23 @@ bool Algorithms::dfsCycleCheck(const Graph& g, int v, vector<bool>& visited, vec
         }
     }
 
-    visited[v] = true;
-    for (int i = 0; i < n; ++i) {
-        // if there is an edge from the current node to node i - the adjacent node
-        if (g.getAdjacencyMatrix()[v][i] != 0) {
-            // if the adjacent node is not visited - mean that he is still white, so we need to visit him
-            if (!visited[i]) {
-                parent[i] = v;
-                if (dfsCycleCheck(g, i, visited, parent)) {
-                    return true;
-                }
-            }
-            // check again if there is a back edge to the parent node
-            else if (parent[v] != i && g.getAdjacencyMatrix()[i][v] != 0) { // Weighted graph handling
-                return true; // Found a cycle
+    visited.mark(v);
+    ARIEL_COUNT(verticesVisited, 1);
+    for (const Neighbor& e : g.neighbors(v)) {
+        // e is an edge from the current node to node i - the adjacent node
+        int i = e.vertex;
+        // if the adjacent node is not visited - mean that he is still white, so we need to visit him
+        if (!visited.contains(i)) {
+            parent[i] = v;
+            if (dfsCycleCheck(g, i, visited, parent)) {
+                return true;
             }
         }
+        // check again if there is a back edge to the parent node
+        else if (parent[v] != i && g.getAdjacencyMatrix()[i][v] != 0) { // Weighted graph handling
+            return true; // Found a cycle
+        }
     }
-    visited[v] = false; // Unmark the current node as visited
+    visited.unmark(v); // Unmark the current node as visited
     return false;
 }
@@ -6,26 +6,119 @@
 #define ALGORITHMS_HPP
 
 #include "Graph.hpp"
+#include "DisjointSet.hpp"
+#include "VisitedSet.hpp"
 #include <vector>
 #include <string>
+#include <utility>
+#include <functional>
 using namespace std;
 
 // we define here the class Algorithms because it's contain a lot of code.
 namespace ariel {
+    // Selects how shortestPath and bellmanFord relax the edges of the graph.
+    // BellmanFord relaxes all the vertices in index order n-1 times.
+    // GoldbergRadzik relaxes in a DFS topological order, so a DAG is solved in one pass.
+    // Dijkstra and DeltaStepping are for graphs without negative edges (they throw
+    // invalid_argument otherwise). DeltaStepping relaxes buckets of vertices on the thread pool.
+    // bellmanFord runs the last two as BellmanFord, it has to look for negative cycles.
+    enum class ShortestPathEngine {
+        BellmanFord,
+        GoldbergRadzik,
+        Dijkstra,
+        DeltaStepping
+    };
+
+    // Counts of the whole matrix, found by graphStats in one pass over the rows.
+    // An edge is a non zero entry, so an undirected edge is counted in both directions.
+    // minWeight and maxWeight are 0 when the graph has no edges.
+    struct GraphStats {
+        size_t vertices = 0;
+        size_t edges = 0;
+        size_t negativeEdges = 0;
+        size_t selfLoops = 0;
+        int minWeight = 0;
+        int maxWeight = 0;
+        std::vector<size_t> outDegree;
+        std::vector<size_t> inDegree;
+    };
+
+    class LandmarkIndex;
+
+    // The answer of a point to point search. distance is INT_MAX and path is empty when the end
+    // can't be reached. settled counts the vertices taken out of the queue, the part of the
+    // graph the search had to look at.
+    struct PathResult {
+        int distance = 0;
+        std::vector<int> path;
+        size_t settled = 0;
+    };
+
+    // The distance estimates of aStar between two vertices with coordinates
+    enum class Heuristic {
+        Euclidean,  // straight line
+        Manhattan   // |dx| + |dy|, for graphs whose edges go along the axes like a grid
+    };
+
     class Algorithms {
     public:
         static bool isConnected(const Graph& g);
-        static std::string shortestPath(const Graph& g, int start, int end);
+        static std::string shortestPath(const Graph& g, int start, int end,
+                                        ShortestPathEngine engine = ShortestPathEngine::BellmanFord);
+        // The same query answered by A* with the bounds of a landmark index built for g
+        static std::string shortestPath(const Graph& g, int start, int end, const LandmarkIndex& landmarks);
+        static std::vector<std::string> shortestPaths(const Graph& g, const std::vector<std::pair<int, int>>& queries,
+                                                      ShortestPathEngine engine = ShortestPathEngine::BellmanFord);
+        static void singleSourcePaths(const Graph& g, int start, bool directed, ShortestPathEngine engine,
+                                      std::vector<int>& dist, std::vector<int>& prev);
+        static std::vector<std::vector<int>> hopDistances(const Graph& g, const std::vector<int>& sources);
+        static bool reachesAll(const Graph& g, const std::vector<int>& sources);
+        static std::string pathToString(const std::vector<int>& prev, int end);
         static bool isContainsCycle(const Graph& g);
         static std::string isBipartite(const Graph& g);
+        // The BFS coloring of isBipartite, with the searches started from the vertices in the given
+        // order (an isolated vertex takes the color of the parity of its place in it).
+        // Returns false if the graph has an odd cycle.
+        static bool bipartiteColors(const Graph& g, const std::vector<int>& order, std::vector<int>& colors);
+        // The answer of isBipartite for a coloring, "The graph is bipartite: A={...}, B={...}"
+        static std::string bipartiteToString(const std::vector<int>& colors);
+        static bool isBipartiteStream(size_t n, const std::vector<std::pair<int, int>>& edges);
         static std::string negativeCycle(const Graph& g);
+        // The same, with the source of the Bellman-Ford run on an undirected graph given
+        // (negativeCycle(g) starts it from vertex 2)
+        static std::string negativeCycle(const Graph& g, int undirectedSource);
         static bool isDirected(const Graph& g);
+        static void dfs(const Graph& g, size_t node, VisitedSet& visited, size_t n);
+        static bool dfsCycleCheck(const Graph& g, int v, VisitedSet& visited, vector<int>& parent);
+        // The old signatures with vector<bool> marks. They copy the marks into a VisitedSet,
+        // run the search and copy them back, so they cost O(n) more per call.
         static void dfs(const Graph& g, size_t node, std::vector<bool>& visited, size_t n);
         static bool dfsCycleCheck(const Graph& g, int v, vector<bool>& visited, vector<int>& parent);
-        static bool bellmanFord(const Graph& g, std::vector<int>& dist); // Updated function
+        static bool bellmanFord(const Graph& g, std::vector<int>& dist,
+                                ShortestPathEngine engine = ShortestPathEngine::BellmanFord); // Updated function
         static bool hasNegativeEdge(const Graph& g, std::vector<int>& dist); // Updated function
+        static GraphStats graphStats(const Graph& g, bool parallel = false);
         static void relax(const Graph& g, vector<int>& dist, vector<int>& parent);
+        static void relax(const Graph& g, vector<int>& dist, vector<int>& parent, bool directed);
+        // Returns the number of passes, at most 1 on a DAG
+        static int goldbergRadzik(const Graph& g, vector<int>& dist, vector<int>& parent);
+        static int goldbergRadzik(const Graph& g, vector<int>& dist, vector<int>& parent, bool directed);
         static bool hasNegativeCycle(const Graph& g, const vector<int>& dist);  
+        static void dijkstra(const Graph& g, int start, vector<int>& dist, vector<int>& parent);
+        static void deltaStepping(const Graph& g, int start, vector<int>& dist, vector<int>& parent, int delta = 0);
+        static int autoDelta(const Graph& g);
+
+        // A* search from start to end. heuristic(v) estimates the distance from v to end, it must
+        // never be more than the real distance for the path to be the shortest. The weights must not
+        // be negative (invalid_argument otherwise).
+        static PathResult aStarSearch(const Graph& g, int start, int end, const std::function<double(int)>& heuristic);
+        static std::string aStar(const Graph& g, int start, int end, const std::function<double(int)>& heuristic);
+        // A* with the "x" and "y" attributes of the vertices. The distance between the coordinates,
+        // times scale, must not be more than the weight of an edge between them.
+        static std::string aStar(const Graph& g, int start, int end, Heuristic kind, double scale = 1.0);
+        // The heuristic of the distance to end over the coordinate arrays x and y
+        static std::function<double(int)> coordinateHeuristic(const std::vector<double>& x, const std::vector<double>& y,
+                                                               int end, Heuristic kind, double scale = 1.0);
 
     
   
@@ -0,0 +1,335 @@
+// Mail: tzohary1234@gmail.com
+// Author: Tzohar Lary
+
+// Times every function of Algorithms over synthetic graphs and writes the results
+// to bench_results.json and bench_results.csv, so runs of different versions can be compared.
+// Usage: ./bench [--families erdos-renyi,grid,power-law,dag] [--sizes 256,1024,4096] [--densities 0.01,0.1]
+//                [--reps 11] [--out bench_results]
+
+#include "Graph.hpp"
+#include "Algorithms.hpp"
+#include "GraphGenerator.hpp"
+#include "AlgorithmStats.hpp"
+#include "SimdKernels.hpp"
+#include "LandmarkIndex.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace ariel;
+
+struct BenchConfig {
+    string family;  // "erdos-renyi", "grid", "power-law" or "dag"
+    size_t n;
+    double density;
+    bool directed;
+    string weights; // "unit", "positive" or "mixed"
+};
+
+static const vector<string> FAMILIES = {"erdos-renyi", "grid", "power-law", "dag"};
+
+// The most matrix cells one timed call may read. The Bellman-Ford cases that would read more
+// (estimated from n and the edges) are skipped, so the large sizes finish in minutes.
+static const double MAX_CELLS = 5e8;
+
+struct BenchResult {
+    string function;
+    BenchConfig config;
+    size_t edges;
+    size_t reps;
+    double medianUs;
+    double p99Us;
+};
+
+static WeightRange weightRange(const string& weights) {
+    if (weights == "unit") {
+        return WeightRange{1, 1};
+    }
+    if (weights == "positive") {
+        return WeightRange{1, 100};
+    }
+    return WeightRange{-10, 100}; // mixed: about one edge in ten is negative
+}
+
+static size_t countEdges(const Graph& g) {
+    size_t edges = 0;
+    for (const auto& row : g.getAdjacencyMatrix()) {
+        for (int w : row) {
+            edges += w != 0;
+        }
+    }
+    return edges;
+}
+
+// Builds the graph of the case, the seed depends only on the size so every run sees the same graphs
+static Graph makeGraph(const BenchConfig& config, size_t& edges) {
+    GraphGenerator generator(12345u + config.n, weightRange(config.weights));
+    Graph g;
+    if (config.family == "grid") {
+        // the most square rows x cols with exactly n vertices, so every family has n vertices
+        size_t rows = 1;
+        for (size_t r = 1; r * r <= config.n; ++r) {
+            if (config.n % r == 0) {
+                rows = r;
+            }
+        }
+        generator.grid(g, rows, config.n / rows);
+    } else if (config.family == "power-law") {
+        generator.powerLaw(g, config.n, max<size_t>(1, config.density * config.n / 2));
+    } else if (config.family == "dag") {
+        generator.dag(g, config.n, config.density);
+    } else if (config.family == "erdos-renyi") {
+        generator.erdosRenyi(g, config.n, config.density, config.directed);
+    } else {
+        throw invalid_argument("Unknown graph family " + config.family);
+    }
+    edges = countEdges(g);
+    return g;
+}
+
+static BenchResult measure(const string& name, const BenchConfig& config, size_t edges, size_t reps,
+                           const function<void()>& body) {
+    vector<double> times;
+    body(); // warm up
+    for (size_t r = 0; r < reps; ++r) {
+        chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+        body();
+        chrono::steady_clock::time_point end = chrono::steady_clock::now();
+        times.push_back(chrono::duration<double, micro>(end - begin).count());
+    }
+    sort(times.begin(), times.end());
+    BenchResult result;
+    result.function = name;
+    result.config = config;
+    result.edges = edges;
+    result.reps = reps;
+    result.medianUs = times[times.size() / 2];
+    size_t p99 = (times.size() * 99 + 99) / 100; // ceil(0.99 * reps)
+    result.p99Us = times[p99 - 1];
+    return result;
+}
+
+// Runs the function and ignores the exceptions it throws on purpose (like a negative cycle)
+static void quietly(const function<void()>& body) {
+    try {
+        body();
+    } catch (const exception&) {
+    }
+}
+
+static vector<string> splitList(const string& text) {
+    vector<string> items;
+    stringstream ss(text);
+    string item;
+    while (getline(ss, item, ',')) {
+        items.push_back(item);
+    }
+    return items;
+}
+
+static vector<double> parseList(const string& text) {
+    vector<double> values;
+    for (const string& item : splitList(text)) {
+        values.push_back(atof(item.c_str()));
+    }
+    return values;
+}
+
+static double throughput(const BenchResult& r) {
+    // edges per second, every function reads each edge at least once
+    return r.medianUs > 0 ? r.edges / (r.medianUs / 1e6) : 0;
+}
+
+static void writeCsv(const vector<BenchResult>& results, const string& path) {
+    ofstream out(path.c_str());
+    out << "function,family,n,density,directed,weights,edges,reps,median_us,p99_us,edges_per_s\n";
+    for (const BenchResult& r : results) {
+        out << r.function << "," << r.config.family << "," << r.config.n << "," << r.config.density << ","
+            << (r.config.directed ? "true" : "false") << "," << r.config.weights << ","
+            << r.edges << "," << r.reps << "," << r.medianUs << "," << r.p99Us << ","
+            << throughput(r) << "\n";
+    }
+}
+
+static void writeJson(const vector<BenchResult>& results, const string& path) {
+    ofstream out(path.c_str());
+    out << "[\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        out << "  {\"function\": \"" << r.function << "\", \"family\": \"" << r.config.family
+            << "\", \"n\": " << r.config.n
+            << ", \"density\": " << r.config.density
+            << ", \"directed\": " << (r.config.directed ? "true" : "false")
+            << ", \"weights\": \"" << r.config.weights << "\", \"edges\": " << r.edges
+            << ", \"reps\": " << r.reps << ", \"median_us\": " << r.medianUs
+            << ", \"p99_us\": " << r.p99Us << ", \"edges_per_s\": " << throughput(r) << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+}
+
+static void runCase(const BenchConfig& config, size_t reps, vector<BenchResult>& results, size_t& skipped) {
+    size_t edges = 0;
+    Graph g = makeGraph(config, edges);
+    // the queries go to the last vertex the generator really built
+    int last = g.getAdjacencyMatrix().size() - 1;
+
+    // One Bellman-Ford run is n - 1 passes over the rows. With negative weights it runs in full,
+    // and negativeCycle on a directed graph runs it from every vertex.
+    double bellmanFord = (double)config.n * (config.n + edges);
+    bool negative = config.weights == "mixed";
+    auto timed = [&](const string& name, double cells, const function<void()>& body) {
+        if (cells > MAX_CELLS) {
+            ++skipped;
+            return;
+        }
+        results.push_back(measure(name, config, edges, reps, body));
+    };
+
+    // loading alone, and loading followed by the first componentCount that builds the components
+    results.push_back(measure("loadGraph", config, edges, reps,
+        [&]() { Graph copy; copy.loadGraph(g.getAdjacencyMatrix()); }));
+    results.push_back(measure("loadGraph+componentCount", config, edges, reps,
+        [&]() { Graph copy; copy.loadGraph(g.getAdjacencyMatrix()); copy.componentCount(); }));
+    results.push_back(measure("isConnected", config, edges, reps,
+        [&]() { Algorithms::isConnected(g); }));
+    timed("shortestPath", bellmanFord,
+        [&]() { quietly([&]() { Algorithms::shortestPath(g, 0, last); }); });
+    timed("shortestPath/goldbergRadzik", negative ? bellmanFord : 0,
+        [&]() { quietly([&]() { Algorithms::shortestPath(g, 0, last, ShortestPathEngine::GoldbergRadzik); }); });
+    // the engines for non negative weights (they throw on the mixed weights, which is skipped)
+    if (config.weights != "mixed") {
+        results.push_back(measure("shortestPath/dijkstra", config, edges, reps,
+            [&]() { Algorithms::shortestPath(g, 0, last, ShortestPathEngine::Dijkstra); }));
+        results.push_back(measure("shortestPath/deltaStepping", config, edges, reps,
+            [&]() { Algorithms::shortestPath(g, 0, last, ShortestPathEngine::DeltaStepping); }));
+        // ALT: the index is built once and then every query uses it
+        results.push_back(measure("landmarks/build", config, edges, reps,
+            [&]() { LandmarkIndex(g, 8); }));
+        LandmarkIndex landmarks(g, 8);
+        results.push_back(measure("shortestPath/alt", config, edges, reps,
+            [&]() { Algorithms::shortestPath(g, 0, last, landmarks); }));
+        // the grid has coordinates, so the same corner to corner query can be goal directed
+        if (g.hasAttribute("x")) {
+            results.push_back(measure("aStar/manhattan", config, edges, reps,
+                [&]() { Algorithms::aStar(g, 0, last, Heuristic::Manhattan); }));
+        }
+    }
+    // a batch of n queries from 4 start nodes, like one request of the handler
+    vector<pair<int, int>> queries;
+    for (int q = 0; q <= last; ++q) {
+        queries.push_back(make_pair(q % 4, last - q));
+    }
+    timed("shortestPaths/batch", 4 * bellmanFord,
+        [&]() { quietly([&]() { Algorithms::shortestPaths(g, queries); }); });
+    // On a directed graph isContainsCycle backtracks over every simple path (it unmarks a vertex
+    // when it leaves it), which no size limit can bound, so it is timed on undirected graphs only
+    if (!config.directed) {
+        results.push_back(measure("isContainsCycle", config, edges, reps,
+            [&]() { Algorithms::isContainsCycle(g); }));
+    }
+    results.push_back(measure("isBipartite", config, edges, reps,
+        [&]() { Algorithms::isBipartite(g); }));
+    timed("negativeCycle", !negative ? 0 : config.directed ? config.n * bellmanFord : bellmanFord,
+        [&]() { Algorithms::negativeCycle(g); });
+    results.push_back(measure("isDirected", config, edges, reps,
+        [&]() { Algorithms::isDirected(g); }));
+    results.push_back(measure("hasNegativeEdge", config, edges, reps,
+        [&]() { vector<int> dist; Algorithms::hasNegativeEdge(g, dist); }));
+    results.push_back(measure("graphStats", config, edges, reps,
+        [&]() { Algorithms::graphStats(g); }));
+    results.push_back(measure("graphStats/parallel", config, edges, reps,
+        [&]() { Algorithms::graphStats(g, true); }));
+}
+
+int main(int argc, char** argv) {
+    // large enough for the thread pool, delta-stepping and the vector kernels to do real work
+    vector<string> families = FAMILIES;
+    vector<double> sizes = {256, 1024, 4096};
+    vector<double> densities = {0.01, 0.1};
+    vector<string> weightKinds = {"unit", "positive", "mixed"};
+    size_t reps = 11;
+    string out = "bench_results";
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string flag = argv[i];
+        if (flag == "--families") {
+            families = splitList(argv[i + 1]);
+            for (const string& family : families) {
+                if (find(FAMILIES.begin(), FAMILIES.end(), family) == FAMILIES.end()) {
+                    cerr << "Unknown family " << family << endl;
+                    return 1;
+                }
+            }
+        } else if (flag == "--sizes") {
+            sizes = parseList(argv[i + 1]);
+        } else if (flag == "--densities") {
+            densities = parseList(argv[i + 1]);
+        } else if (flag == "--reps") {
+            reps = max(1, atoi(argv[i + 1]));
+        } else if (flag == "--out") {
+            out = argv[i + 1];
+        } else {
+            cerr << "Unknown option " << flag << endl;
+            return 1;
+        }
+    }
+
+    // grid and power-law are undirected and dag is directed, only erdos-renyi is drawn both ways
+    vector<BenchConfig> configs;
+    for (const string& family : families) {
+        for (double size : sizes) {
+            for (double density : densities) {
+                for (int directed = 0; directed < 2; ++directed) {
+                    if (family != "erdos-renyi" && (directed == 1) != (family == "dag")) continue;
+                    for (const string& weights : weightKinds) {
+                        BenchConfig config = {family, (size_t)size, density, directed == 1, weights};
+                        configs.push_back(config);
+                    }
+                }
+            }
+        }
+    }
+
+    vector<BenchResult> results;
+    size_t skipped = 0;
+    for (const BenchConfig& config : configs) {
+        try {
+            runCase(config, reps, results, skipped);
+        } catch (const invalid_argument& e) {
+            // a family that can't be built with these parameters, like power-law with density >= 2
+            cerr << "Skipping " << config.family << " n=" << config.n << " density=" << config.density
+                 << ": " << e.what() << endl;
+        }
+    }
+
+    // ARIEL_SIMD=scalar ./bench times the same build without the vector kernels
+    cout << "SIMD kernels: " << SimdKernels::levelName(SimdKernels::level()) << endl;
+    cout << "function                       family          n  density  directed  weights     median_us      p99_us    edges/s" << endl;
+    for (const BenchResult& r : results) {
+        printf("%-30s %-12s %4zu  %7.2f  %8s  %-8s  %12.1f  %10.1f  %9.3g\n", r.function.c_str(), r.config.family.c_str(), r.config.n,
+               r.config.density, r.config.directed ? "yes" : "no", r.config.weights.c_str(),
+               r.medianUs, r.p99Us, throughput(r));
+    }
+    if (skipped > 0) {
+        cout << skipped << " Bellman-Ford cases skipped, they read more than " << MAX_CELLS << " cells per call" << endl;
+    }
+    writeJson(results, out + ".json");
+    writeCsv(results, out + ".csv");
+    cout << "Results written to " << out << ".json and " << out << ".csv" << endl;
+#ifdef ARIEL_ENABLE_STATS
+    cout << endl;
+    StatsRegistry::print(cout);
+#endif
+    return 0;
+}
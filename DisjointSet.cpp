@@ -0,0 +1,124 @@
+// Mail: tzohary1234@gmail.com
+// Author: Tzohar Lary
+
+#include "DisjointSet.hpp"
+#include <stdexcept>
+
+using namespace std;
+using namespace ariel;
+
+DisjointSet::DisjointSet(size_t n) {
+    reset(n);
+}
+
+void DisjointSet::reset(size_t n) {
+    parent.resize(n);
+    rank.assign(n, 0);
+    parity.assign(n, 0);
+    for (size_t i = 0; i < n; ++i) {
+        parent[i] = i; // every vertex is the root of its own set
+    }
+    components = n;
+    bipartite = true;
+}
+
+size_t DisjointSet::size() const {
+    return parent.size();
+}
+
+int DisjointSet::addVertex() {
+    int v = parent.size();
+    parent.push_back(v);
+    rank.push_back(0);
+    parity.push_back(0);
+    ++components;
+    return v;
+}
+
+int DisjointSet::find(int x) {
+    if (x < 0 || x >= (int)parent.size()) {
+        throw out_of_range("Index out of range");
+    }
+    // First pass: find the root and the parity of x relative to it
+    int root = x;
+    int acc = 0;
+    while (parent[root] != root) {
+        acc ^= parity[root];
+        root = parent[root];
+    }
+    // Second pass: point every vertex on the path straight to the root (path compression)
+    // and replace its parity with the parity of its whole path.
+    while (parent[x] != x) {
+        int next = parent[x];
+        int nextAcc = acc ^ parity[x];
+        parent[x] = root;
+        parity[x] = acc;
+        x = next;
+        acc = nextAcc;
+    }
+    return root;
+}
+
+int DisjointSet::parityOf(int x) {
+    // after find, x points straight to the root, so its parity is the parity of the whole path
+    int root = find(x);
+    return x == root ? 0 : parity[x];
+}
+
+void DisjointSet::link(int rootU, int rootV, int linkParity) {
+    // union by rank: the lower tree is hanged under the higher one
+    if (rank[rootU] < rank[rootV]) {
+        int tmp = rootU;
+        rootU = rootV;
+        rootV = tmp;
+    }
+    parent[rootV] = rootU;
+    parity[rootV] = linkParity;
+    if (rank[rootU] == rank[rootV]) {
+        ++rank[rootU];
+    }
+    --components;
+}
+
+bool DisjointSet::unite(int u, int v) {
+    int rootU = find(u);
+    int rootV = find(v);
+    if (rootU == rootV) {
+        return false; // already in the same set
+    }
+    link(rootU, rootV, 0);
+    return true;
+}
+
+bool DisjointSet::addEdge(int u, int v) {
+    int rootU = find(u);
+    int rootV = find(v);
+    int parityU = u == rootU ? 0 : parity[u];
+    int parityV = v == rootV ? 0 : parity[v];
+    if (rootU == rootV) {
+        // both ends are already in one set, the edge closes an odd cycle if they are on the same side
+        if (parityU == parityV) {
+            bipartite = false;
+        }
+    } else {
+        // the roots get a parity that puts u and v on opposite sides
+        link(rootU, rootV, parityU ^ parityV ^ 1);
+    }
+    return bipartite;
+}
+
+bool DisjointSet::sameSet(int u, int v) {
+    return find(u) == find(v);
+}
+
+bool DisjointSet::sameSide(int u, int v) {
+    return sameSet(u, v) && parityOf(u) == parityOf(v);
+}
+
+bool DisjointSet::isBipartite() const {
+    return bipartite;
+}
+
+size_t DisjointSet::componentCount() const {
+    return components;
+}
@@ -0,0 +1,44 @@
+// Mail: tzohary1234@gmail.com
+// Author: Tzohar Lary
+
+
+#ifndef DISJOINTSET_HPP
+#define DISJOINTSET_HPP
+
+#include <vector>
+#include <cstddef>
+
+namespace ariel {
+    // Union-find with path compression and union by rank.
+    // Every vertex also keeps the parity (0 or 1) of its path to the root, so edges added
+    // with addEdge put their two ends on opposite sides and an odd cycle is found when
+    // an edge connects two vertices that are already on the same side.
+    // A set is used either for connectivity (unite) or for parity (addEdge), not both.
+    class DisjointSet {
+        private:
+            std::vector<int> parent;
+            std::vector<int> rank;
+            std::vector<int> parity; // parity of the edge to the parent
+            size_t components = 0;
+            bool bipartite = true;
+
+            // links two different roots, child root gets the given parity
+            void link(int rootU, int rootV, int linkParity);
+
+        public:
+            explicit DisjointSet(size_t n = 0);
+            void reset(size_t n);
+            size_t size() const;
+            int addVertex();
+            int find(int x);
+            int parityOf(int x);
+            bool unite(int u, int v);
+            bool addEdge(int u, int v);
+            bool sameSet(int u, int v);
+            bool sameSide(int u, int v);
+            bool isBipartite() const;
+            size_t componentCount() const;
+    };
+}
+
+#endif // DISJOINTSET_HPP
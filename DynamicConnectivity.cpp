@@ -0,0 +1,301 @@
+// Mail: tzohary1234@gmail.com
+// Author: Tzohar Lary
+
+#include "DynamicConnectivity.hpp"
+#include <stdexcept>
+
+using namespace std;
+using namespace ariel;
+
+DynamicConnectivity::DynamicConnectivity(size_t n) {
+    reset(n);
+}
+
+void DynamicConnectivity::reset(size_t n) {
+    treeEdges.assign(n, map<int, int>());
+    nonTreeAt.assign(n, vector<set<int>>());
+    label.resize(n);
+    labelSize.assign(n, 1);
+    freeLabels.clear();
+    for (size_t i = 0; i < n; ++i) {
+        label[i] = i; // every vertex starts as a component of its own
+    }
+    components = n;
+    stamp.assign(n, 0);
+    epoch = 0;
+}
+
+size_t DynamicConnectivity::size() const {
+    return label.size();
+}
+
+int DynamicConnectivity::newLabel() {
+    if (!freeLabels.empty()) {
+        int l = freeLabels.back();
+        freeLabels.pop_back();
+        return l;
+    }
+    labelSize.push_back(0);
+    return labelSize.size() - 1;
+}
+
+unsigned DynamicConnectivity::nextStamp() {
+    if (epoch == ~0u) {
+        // the stamps wrapped around, clear them once
+        stamp.assign(stamp.size(), 0);
+        epoch = 0;
+    }
+    return ++epoch;
+}
+
+int DynamicConnectivity::addVertex() {
+    int v = label.size();
+    treeEdges.push_back(map<int, int>());
+    nonTreeAt.push_back(vector<set<int>>());
+    int l = newLabel();
+    label.push_back(l);
+    labelSize[l] = 1;
+    stamp.push_back(0);
+    ++components;
+    return v;
+}
+
+void DynamicConnectivity::removeLastVertex() {
+    if (label.empty()) {
+        return;
+    }
+    int x = label.size() - 1;
+    // delete all the edges of x, so only x is left in its component
+    vector<int> neighbors;
+    for (const pair<const int, int>& e : treeEdges[x]) {
+        neighbors.push_back(e.first);
+    }
+    for (const set<int>& level : nonTreeAt[x]) {
+        neighbors.insert(neighbors.end(), level.begin(), level.end());
+    }
+    for (int y : neighbors) {
+        deleteEdge(x, y);
+    }
+    if (--labelSize[label[x]] == 0) {
+        freeLabels.push_back(label[x]);
+    }
+    --components;
+    treeEdges.pop_back();
+    nonTreeAt.pop_back();
+    label.pop_back();
+    stamp.pop_back();
+}
+
+void DynamicConnectivity::relabel(const vector<int>& side, int l) {
+    for (int x : side) {
+        if (--labelSize[label[x]] == 0) {
+            freeLabels.push_back(label[x]);
+        }
+        label[x] = l;
+        ++labelSize[l];
+    }
+}
+
+void DynamicConnectivity::collectTree(int start, vector<int>& side) {
+    // BFS over the tree edges only
+    unsigned s = nextStamp();
+    side.clear();
+    side.push_back(start);
+    stamp[start] = s;
+    for (size_t head = 0; head < side.size(); ++head) {
+        for (const pair<const int, int>& e : treeEdges[side[head]]) {
+            int y = e.first;
+            if (stamp[y] != s) {
+                stamp[y] = s;
+                side.push_back(y);
+            }
+        }
+    }
+}
+
+unsigned DynamicConnectivity::smallerSide(int u, int v, int level, vector<int>& side) {
+    // Two BFS runs over the tree edges of the level or above, one step at a time each.
+    // The tree edge between u and v was already removed, so the first search that
+    // runs out of vertices found the whole smaller side, in time of the smaller side.
+    unsigned stampU = nextStamp();
+    unsigned stampV = nextStamp();
+    vector<int> sideU(1, u);
+    vector<int> sideV(1, v);
+    stamp[u] = stampU;
+    stamp[v] = stampV;
+    size_t headU = 0;
+    size_t headV = 0;
+    while (true) {
+        if (headU == sideU.size()) {
+            side.swap(sideU);
+            return stampU;
+        }
+        for (const pair<const int, int>& e : treeEdges[sideU[headU]]) {
+            int y = e.first;
+            if (e.second >= level && stamp[y] != stampU) {
+                stamp[y] = stampU;
+                sideU.push_back(y);
+            }
+        }
+        ++headU;
+
+        if (headV == sideV.size()) {
+            side.swap(sideV);
+            return stampV;
+        }
+        for (const pair<const int, int>& e : treeEdges[sideV[headV]]) {
+            int y = e.first;
+            if (e.second >= level && stamp[y] != stampV) {
+                stamp[y] = stampV;
+                sideV.push_back(y);
+            }
+        }
+        ++headV;
+    }
+}
+
+void DynamicConnectivity::insertEdge(int u, int v) {
+    if (u < 0 || u >= (int)label.size() || v < 0 || v >= (int)label.size()) {
+        throw out_of_range("Index out of range");
+    }
+    if (u == v || hasEdge(u, v)) {
+        return; // a self loop never changes the components
+    }
+    // a new edge starts at level 0
+    if (label[u] == label[v]) {
+        addNonTree(u, v, 0);
+        return;
+    }
+    // the edge joins two components, the smaller one takes the label of the bigger one
+    vector<int> side;
+    if (labelSize[label[u]] < labelSize[label[v]]) {
+        collectTree(u, side);
+        relabel(side, label[v]);
+    } else {
+        collectTree(v, side);
+        relabel(side, label[u]);
+    }
+    treeEdges[u][v] = 0;
+    treeEdges[v][u] = 0;
+    --components;
+}
+
+set<int>& DynamicConnectivity::nonTreeLevel(int v, int level) {
+    vector<set<int>>& levels = nonTreeAt[v];
+    if ((int)levels.size() <= level) {
+        levels.resize(level + 1);
+    }
+    return levels[level];
+}
+
+void DynamicConnectivity::addNonTree(int u, int v, int level) {
+    nonTreeLevel(u, level).insert(v);
+    nonTreeLevel(v, level).insert(u);
+}
+
+int DynamicConnectivity::findNonTree(int u, int v) const {
+    for (size_t i = 0; i < nonTreeAt[u].size(); ++i) {
+        if (nonTreeAt[u][i].count(v) > 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void DynamicConnectivity::removeNonTree(int u, int v, int level) {
+    nonTreeAt[u][level].erase(v);
+    nonTreeAt[v][level].erase(u);
+}
+
+// One level of a deletion: side is the smaller side of the cut between u and v in the forest of
+// the level. Returns true if a non-tree edge of the level reconnects the two sides.
+bool DynamicConnectivity::replace(int u, int v, int level, vector<int>& side) {
+    unsigned sideStamp = smallerSide(u, v, level, side);
+    // The side has at most half of the vertices of its tree, so its tree edges of this level can
+    // move up without breaking the size bound of the next level
+    for (int x : side) {
+        for (pair<const int, int>& e : treeEdges[x]) {
+            if (e.second == level) {
+                e.second = level + 1;
+                treeEdges[e.first][x] = level + 1;
+            }
+        }
+    }
+    for (int x : side) {
+        if ((int)nonTreeAt[x].size() <= level) {
+            continue;
+        }
+        nonTreeLevel(x, level + 1); // grown first, so moving edges up doesn't move this set
+        set<int>& candidates = nonTreeAt[x][level];
+        while (!candidates.empty()) {
+            int y = *candidates.begin();
+            removeNonTree(x, y, level);
+            if (stamp[y] != sideStamp) {
+                // it leaves the side, so it becomes the tree edge in place of the deleted one
+                treeEdges[x][y] = level;
+                treeEdges[y][x] = level;
+                return true;
+            }
+            // both ends are on the side, so it moves up and this level won't scan it again
+            addNonTree(x, y, level + 1);
+        }
+    }
+    return false;
+}
+
+void DynamicConnectivity::deleteEdge(int u, int v) {
+    if (u < 0 || u >= (int)label.size() || v < 0 || v >= (int)label.size()) {
+        throw out_of_range("Index out of range");
+    }
+    int nonTree = findNonTree(u, v);
+    if (nonTree != -1) {
+        // a non-tree edge is not needed for the connectivity
+        removeNonTree(u, v, nonTree);
+        return;
+    }
+    map<int, int>::iterator tree = treeEdges[u].find(v);
+    if (tree == treeEdges[u].end()) {
+        return; // there is no such edge
+    }
+    int level = tree->second;
+    treeEdges[u].erase(tree);
+    treeEdges[v].erase(u);
+
+    // look for a replacement from the level of the edge down, the last side searched is the
+    // smaller side in the whole spanning forest
+    vector<int> side;
+    for (int i = level; i >= 0; --i) {
+        if (replace(u, v, i, side)) {
+            return;
+        }
+    }
+    // no replacement, the smaller side becomes a new component
+    relabel(side, newLabel());
+    ++components;
+}
+
+bool DynamicConnectivity::hasEdge(int u, int v) const {
+    return treeEdges[u].count(v) > 0 || findNonTree(u, v) != -1;
+}
+
+int DynamicConnectivity::edgeLevel(int u, int v) const {
+    if (u < 0 || u >= (int)label.size() || v < 0 || v >= (int)label.size()) {
+        throw out_of_range("Index out of range");
+    }
+    map<int, int>::const_iterator e = treeEdges[u].find(v);
+    if (e != treeEdges[u].end()) {
+        return e->second;
+    }
+    return findNonTree(u, v);
+}
+
+bool DynamicConnectivity::connected(int u, int v) const {
+    if (u < 0 || u >= (int)label.size() || v < 0 || v >= (int)label.size()) {
+        throw out_of_range("Index out of range");
+    }
+    return label[u] == label[v];
+}
+
+size_t DynamicConnectivity::componentCount() const {
+    return components;
+}
@@ -0,0 +1,71 @@
+// Mail: tzohary1234@gmail.com
+// Author: Tzohar Lary
+
+
+#ifndef DYNAMICCONNECTIVITY_HPP
+#define DYNAMICCONNECTIVITY_HPP
+
+#include <vector>
+#include <set>
+#include <map>
+#include <cstddef>
+
+namespace ariel {
+    // Connected components of an undirected graph under edge insertions and deletions.
+    // It keeps a spanning forest: every vertex has a component label, edges that connect two
+    // components become tree edges and the rest are kept as non-tree edges.
+    // Labels are moved to the smaller side only, so connected() and componentCount() are O(1).
+    //
+    // Every edge has a level, as in Holm, de Lichtenberg and Thorup. A new edge starts at level 0,
+    // and the tree edges of level i or more form a forest whose trees have at most n / 2^i vertices.
+    // When a tree edge of level l is deleted, for i = l down to 0 the smaller side of the cut in the
+    // forest of level i is searched (both sides together, stopping with the smaller one), its tree
+    // edges of level i move up to i + 1, and its non-tree edges of level i are scanned: the first
+    // one that leaves the side replaces the deleted edge, and every one that stays inside moves up
+    // to i + 1. An edge moves up at most log n times, so the scans of non-tree edges cost
+    // O(log^2 n) amortized per update (the sets add one log). The sides are found by a search over
+    // the tree edges instead of Euler tour trees, so that part costs the size of the smaller side
+    // at every level it looks at.
+    class DynamicConnectivity {
+        private:
+            std::vector<std::map<int, int>> treeEdges;     // tree neighbor -> level of the edge
+            // nonTreeAt[v][i] holds the non-tree neighbors of v at level i, grown on demand.
+            // The level of a non-tree edge is found by looking in the O(log n) sets of v.
+            std::vector<std::vector<std::set<int>>> nonTreeAt;
+            std::vector<int> label;         // component label of every vertex
+            std::vector<size_t> labelSize;  // number of vertices with every label
+            std::vector<int> freeLabels;    // labels that are not used anymore
+            size_t components = 0;
+
+            // search stamps, a vertex is on the current side if its stamp equals the epoch
+            std::vector<unsigned> stamp;
+            unsigned epoch = 0;
+
+            int newLabel();
+            void relabel(const std::vector<int>& side, int newLabel);
+            void collectTree(int start, std::vector<int>& side);
+            unsigned nextStamp();
+            unsigned smallerSide(int u, int v, int level, std::vector<int>& side);
+            std::set<int>& nonTreeLevel(int v, int level);
+            void addNonTree(int u, int v, int level);
+            void removeNonTree(int u, int v, int level);
+            int findNonTree(int u, int v) const;  // the level of the non-tree edge u-v, -1 if there is none
+            bool replace(int u, int v, int level, std::vector<int>& side);
+
+        public:
+            explicit DynamicConnectivity(size_t n = 0);
+            void reset(size_t n);
+            size_t size() const;
+            int addVertex();
+            void removeLastVertex();
+            void insertEdge(int u, int v);
+            void deleteEdge(int u, int v);
+            bool hasEdge(int u, int v) const;
+            bool connected(int u, int v) const;
+            size_t componentCount() const;
+            // The level of the edge u-v, -1 if there is no such edge
+            int edgeLevel(int u, int v) const;
+    };
+}
+
+#endif // DYNAMICCONNECTIVITY_HPP
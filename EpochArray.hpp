@@ -0,0 +1,53 @@
+// Mail: tzohary1234@gmail.com
+// Author: Tzohar Lary
+
+
+#ifndef EPOCHARRAY_HPP
+#define EPOCHARRAY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ariel {
+    // An array of n values that all start as the same value, reset in O(1) like a VisitedSet.
+    // Every entry keeps the stamp of the epoch that wrote it, and an entry with an old stamp
+    // reads as the start value. A search that stops early, like A*, only pays for the entries
+    // it writes instead of filling all n of them on every call.
+    template <typename T>
+    class EpochArray {
+        private:
+            std::vector<T> values;
+            std::vector<uint32_t> stamps;
+            uint32_t epoch = 1;
+            T start = T();
+
+        public:
+            EpochArray() {}
+
+            // Starts a new use with n entries that all read as value. When the size didn't
+            // change the old entries are kept and only the epoch moves.
+            void prepare(size_t n, const T& value) {
+                start = value;
+                if (stamps.size() != n) {
+                    values.assign(n, value);
+                    stamps.assign(n, 0);
+                    epoch = 1;
+                } else if (++epoch == 0) {
+                    // after 2^32 uses the old stamps could look current again
+                    stamps.assign(n, 0);
+                    epoch = 1;
+                }
+            }
+
+            size_t size() const { return stamps.size(); }
+            T operator[](size_t v) const { return stamps[v] == epoch ? values[v] : start; }
+
+            void set(size_t v, const T& value) {
+                values[v] = value;
+                stamps[v] = epoch;
+            }
+    };
+}
+
+#endif // EPOCHARRAY_HPP
@@ -2,6 +2,10 @@
 // Author: Tzohar Lary
        
 #include "Graph.hpp"
+#include "SimdKernels.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <atomic>
 
 using namespace std;
 using namespace ariel;
@@ -17,6 +21,102 @@ void Graph::loadGraph(const vector<vector<int>>& matrix) {
         }
     }
     adjacencyMatrix = matrix;
+    components.clear();
+    transpose.clear();
+
+    adjacencyLists.assign(size, vector<Neighbor>());
+    changed();
+    attributes.clear();
+    for (size_t i = 0; i < size; ++i) {
+        adjacencyLists[i].reserve(count_if(matrix[i].begin(), matrix[i].end(), [](int w) { return w != 0; }));
+        for (size_t j = 0; j < size; ++j) {
+            if (matrix[i][j] != 0) {
+                adjacencyLists[i].push_back(Neighbor{(int)j, matrix[i][j]});
+            }
+        }
+    }
+
+    // The metadata is computed with the vector kernels, one row at a time
+    edges = 0;
+    negativeEdges = 0;
+    selfLoops = 0;
+    nonUnitEdges = 0;
+    outDegrees.assign(size, 0);
+    vector<uint32_t> in(size, 0);
+    for (size_t i = 0; i < size; ++i) {
+        RowStats row = SimdKernels::rowStats(matrix[i].data(), size, in.data());
+        outDegrees[i] = row.edges;
+        edges += row.edges;
+        negativeEdges += row.negativeEdges;
+        selfLoops += matrix[i][i] != 0;
+        if (row.edges > 0 && (row.minWeight != 1 || row.maxWeight != 1)) {
+            nonUnitEdges += row.edges - count(matrix[i].begin(), matrix[i].end(), 1);
+        }
+    }
+    inDegrees.assign(in.begin(), in.end());
+
+    // Symmetric tiles are skipped at vector speed, only the tiles that differ are counted cell by cell
+    vector<const int*> rows(size);
+    for (size_t i = 0; i < size; ++i) {
+        rows[i] = matrix[i].data();
+    }
+    const size_t TILE = 64;
+    asymmetricPairs = 0;
+    for (size_t i0 = 0; i0 < size; i0 += TILE) {
+        for (size_t j0 = i0; j0 < size; j0 += TILE) {
+            size_t height = min(TILE, size - i0);
+            size_t width = min(TILE, size - j0);
+            if (SimdKernels::symmetricTile(rows.data(), i0, j0, height, width)) {
+                continue;
+            }
+            for (size_t i = i0; i < i0 + height; ++i) {
+                for (size_t j = max(j0, i + 1); j < j0 + width; ++j) {
+                    asymmetricPairs += matrix[i][j] != matrix[j][i];
+                }
+            }
+        }
+    }
+}
+
+void Graph::loadEmpty(size_t n) {
+    // n vertices and no edges, the edges are then added with setEdge
+    if (n == 0) {
+        throw invalid_argument("Graph is empty");
+    }
+    adjacencyMatrix.assign(n, vector<int>(n, 0));
+    components.clear();
+    transpose.clear();
+    adjacencyLists.assign(n, vector<Neighbor>());
+    changed();
+    attributes.clear();
+    asymmetricPairs = 0;
+    edges = 0;
+    negativeEdges = 0;
+    selfLoops = 0;
+    nonUnitEdges = 0;
+    outDegrees.assign(n, 0);
+    inDegrees.assign(n, 0);
+}
+
+// Adds (sign 1) or removes (sign -1) what the current value of cell (i, j) contributes to the metadata
+void Graph::countCell(int i, int j, int sign) {
+    int w = adjacencyMatrix[i][j];
+    if (w == 0) {
+        return;
+    }
+    edges += sign;
+    negativeEdges += w < 0 ? sign : 0;
+    selfLoops += i == j ? sign : 0;
+    nonUnitEdges += w != 1 ? sign : 0;
+    outDegrees[i] += sign;
+    inDegrees[j] += sign;
+}
+
+// The same for the pair of cells (i, j) and (j, i)
+void Graph::countPair(int i, int j, int sign) {
+    if (i != j && adjacencyMatrix[i][j] != adjacencyMatrix[j][i]) {
+        asymmetricPairs += sign;
+    }
 }
 
 bool Graph::isEmpty() const {
@@ -25,19 +125,67 @@ bool Graph::isEmpty() const {
 
 void Graph::addNode() {
     int n = adjacencyMatrix.size();
-    vector<int> newRow(n + 1, 0);
+    // the new row gets its last cell from the loop below with all the others, so it is square
+    vector<int> newRow(n, 0);
     adjacencyMatrix.push_back(newRow);
     for (auto& row : adjacencyMatrix) {
         row.push_back(0);
     }
+    if (shared_ptr<DynamicConnectivity> built = components.get()) {
+        built->addVertex(); // the new node has no edges, it is a component of its own
+    }
+    outDegrees.push_back(0);
+    inDegrees.push_back(0);
+    adjacencyLists.push_back(vector<Neighbor>());
+    if (shared_ptr<TransposeIndex> index = transpose.exclusive()) {
+        index->lists.push_back(vector<Neighbor>());
+    }
+    changed();
+    for (auto& attr : attributes) {
+        attr.second.push_back(0);
+    }
 }
 
 void Graph::removeNode() {
     if (!adjacencyMatrix.empty()) {
+        // the cells of the last row and column leave the metadata with it
+        int last = adjacencyMatrix.size() - 1;
+        for (int j = 0; j <= last; ++j) {
+            countPair(last, j, -1);
+            countCell(last, j, -1);
+            if (j != last) {
+                countCell(j, last, -1);
+            }
+        }
+        // the last vertex has the largest index, so it is at the back of every list that holds it
+        for (int j = 0; j < last; ++j) {
+            if (adjacencyMatrix[j][last] != 0) {
+                adjacencyLists[j].pop_back();
+            }
+        }
+        adjacencyLists.pop_back();
+        // and at the back of the in-edges of its out-neighbors
+        if (shared_ptr<TransposeIndex> index = transpose.exclusive()) {
+            for (int j = 0; j < last; ++j) {
+                if (adjacencyMatrix[last][j] != 0) {
+                    index->lists[j].pop_back();
+                }
+            }
+            index->lists.pop_back();
+        }
+        changed();
+        outDegrees.pop_back();
+        inDegrees.pop_back();
+        for (auto& attr : attributes) {
+            attr.second.pop_back();
+        }
         adjacencyMatrix.pop_back();
         for (auto& row : adjacencyMatrix) {
             row.pop_back();
         }
+        if (shared_ptr<DynamicConnectivity> built = components.get()) {
+            built->removeLastVertex(); // deletes its edges first, so its component may be split
+        }
     }
 }
 
@@ -45,7 +193,200 @@ void Graph::setEdge(int i, int j, int val) {
     if (i < 0 || i >= adjacencyMatrix.size() || j < 0 || j >= adjacencyMatrix.size()) {
         throw out_of_range("Index out of range");
     }
+    bool connectedBefore = adjacencyMatrix[i][j] != 0 || adjacencyMatrix[j][i] != 0;
+    countCell(i, j, -1);
+    countPair(i, j, -1);
+    updateList(i, j, val);
+    changed();
     adjacencyMatrix[i][j] = val;
+    countCell(i, j, 1);
+    countPair(i, j, 1);
+    bool connectedAfter = adjacencyMatrix[i][j] != 0 || adjacencyMatrix[j][i] != 0;
+    // the components change only when the first edge between i and j is added or the last one is deleted
+    shared_ptr<DynamicConnectivity> built = components.get();
+    if (!built) {
+        return;
+    }
+    if (!connectedBefore && connectedAfter) {
+        built->insertEdge(i, j);
+    } else if (connectedBefore && !connectedAfter) {
+        built->deleteEdge(i, j);
+    }
+}
+
+// Builds the components from the adjacency lists, every pair i < j with an edge either way once
+const DynamicConnectivity& Graph::connectivity() const {
+    shared_ptr<DynamicConnectivity> built = components.get();
+    if (!built) {
+        size_t n = adjacencyMatrix.size();
+        built = make_shared<DynamicConnectivity>(n);
+        for (size_t i = 0; i < n; ++i) {
+            for (const Neighbor& e : adjacencyLists[i]) {
+                size_t j = e.vertex;
+                if (i < j || (j < i && adjacencyMatrix[j][i] == 0)) {
+                    built->insertEdge(i, j);
+                }
+            }
+        }
+        built = components.publish(built);
+    }
+    return *built;
+}
+
+size_t Graph::componentCount() const {
+    return connectivity().componentCount();
+}
+
+bool Graph::hasComponents() const {
+    return components.get() != nullptr;
+}
+
+bool Graph::sameComponent(int u, int v) const {
+    checkVertex(u);
+    checkVertex(v);
+    return connectivity().connected(u, v);
+}
+
+// The next revision of all the graphs, so two graphs never get the same one by different changes
+static atomic<uint64_t> lastRevision(0);
+
+// Called by every change to the edges: takes a new revision
+void Graph::changed() {
+    revision = ++lastRevision;
+}
+
+uint64_t Graph::getRevision() const {
+    return revision;
+}
+
+void Graph::checkVertex(int v) const {
+    if (v < 0 || v >= (int)adjacencyMatrix.size()) {
+        throw out_of_range("Index out of range");
+    }
+}
+
+// Inserts, updates or erases vertex in a list sorted by vertex, where its weight was old
+static void updateSorted(vector<Neighbor>& list, int vertex, int old, int val) {
+    auto at = lower_bound(list.begin(), list.end(), vertex,
+                          [](const Neighbor& e, int v) { return e.vertex < v; });
+    if (old == 0) {
+        if (val != 0) {
+            list.insert(at, Neighbor{vertex, val});
+        }
+    } else if (val == 0) {
+        list.erase(at);
+    } else {
+        at->weight = val;
+    }
+}
+
+// Inserts, updates or erases the edge i->j in the sorted list of i, and in the in-edges of j
+// when the transpose is kept, before the matrix cell changes
+void Graph::updateList(int i, int j, int val) {
+    int old = adjacencyMatrix[i][j];
+    updateSorted(adjacencyLists[i], j, old, val);
+    if (shared_ptr<TransposeIndex> index = transpose.exclusive()) {
+        updateSorted(index->lists[j], i, old, val);
+    }
+}
+
+NeighborRange Graph::neighbors(int u) const {
+    checkVertex(u);
+    const vector<Neighbor>& list = adjacencyLists[u];
+    return NeighborRange(list.data(), list.data() + list.size());
+}
+
+NeighborRange Graph::inNeighbors(int v) const {
+    checkVertex(v);
+    shared_ptr<const TransposeIndex> index = transpose.get();
+    if (!index) {
+        // Bucket sort of the edges by target. The sources are visited in increasing order,
+        // so every list comes out sorted. Two threads may both build it, but only the first
+        // index is published and both use that one.
+        shared_ptr<TransposeIndex> built = make_shared<TransposeIndex>();
+        size_t n = adjacencyLists.size();
+        built->lists.resize(n);
+        for (size_t u = 0; u < n; ++u) {
+            built->lists[u].reserve(inDegrees[u]);
+        }
+        for (size_t u = 0; u < n; ++u) {
+            for (const Neighbor& e : adjacencyLists[u]) {
+                built->lists[e.vertex].push_back(Neighbor{(int)u, e.weight});
+            }
+        }
+        index = transpose.publish(built);
+    }
+    // the graph keeps its own reference, so the range lives until the next change
+    const vector<Neighbor>& list = index->lists[v];
+    return NeighborRange(list.data(), list.data() + list.size());
+}
+
+bool Graph::isDirected() const {
+    return asymmetricPairs > 0;
+}
+
+size_t Graph::edgeCount() const {
+    return edges;
+}
+
+size_t Graph::negativeEdgeCount() const {
+    return negativeEdges;
+}
+
+size_t Graph::selfLoopCount() const {
+    return selfLoops;
+}
+
+bool Graph::hasUnitWeights() const {
+    return nonUnitEdges == 0;
+}
+
+size_t Graph::outDegree(int v) const {
+    checkVertex(v);
+    return outDegrees[v];
+}
+
+size_t Graph::inDegree(int v) const {
+    checkVertex(v);
+    return inDegrees[v];
+}
+
+void Graph::setAttribute(const string& name, int v, double value) {
+    checkVertex(v);
+    vector<double>& values = attributes[name];
+    values.resize(adjacencyMatrix.size(), 0);
+    values[v] = value;
+}
+
+void Graph::setAttributes(const string& name, const vector<double>& values) {
+    if (adjacencyMatrix.empty() || values.size() != adjacencyMatrix.size()) {
+        throw invalid_argument("An attribute needs one value per vertex");
+    }
+    attributes[name] = values;
+}
+
+const vector<double>& Graph::attribute(const string& name) const {
+    auto it = attributes.find(name);
+    if (it == attributes.end()) {
+        throw out_of_range("No attribute named " + name);
+    }
+    return it->second;
+}
+
+bool Graph::hasAttribute(const string& name) const {
+    return attributes.count(name) > 0;
+}
+
+vector<string> Graph::attributeNames() const {
+    vector<string> names;
+    for (const auto& attr : attributes) {
+        names.push_back(attr.first);
+    }
+    return names;
+}
+
+void Graph::removeAttribute(const string& name) {
+    attributes.erase(name);
 }
 
 const vector<vector<int>>& Graph::getAdjacencyMatrix() const {
@@ -8,20 +8,194 @@
 #include <vector>
 #include <iostream>
 #include <stdexcept>
+#include <memory>
+#include <map>
+#include <string>
+#include <cstdint>
+#include "DynamicConnectivity.hpp"
 
 namespace ariel {
+        // One outgoing edge of a vertex: its target and its weight
+        struct Neighbor {
+            int vertex;
+            int weight;
+        };
+
+        // The outgoing edges of a vertex in increasing order of target, the same order as a scan
+        // of its matrix row. It is a plain range of pointers, so a loop over it compiles to a
+        // loop over an array with no virtual calls:
+        //
+        //     for (const Neighbor& e : g.neighbors(u)) { ... e.vertex ... e.weight ... }
+        class NeighborRange {
+            private:
+                const Neighbor* first;
+                const Neighbor* last;
+
+            public:
+                NeighborRange(const Neighbor* first, const Neighbor* last) : first(first), last(last) {}
+                const Neighbor* begin() const { return first; }
+                const Neighbor* end() const { return last; }
+                size_t size() const { return last - first; }
+                bool empty() const { return first == last; }
+                const Neighbor& operator[](size_t k) const { return first[k]; }
+        };
+
+        // The in-edges of every vertex: lists[v] holds the edges into v sorted by source, and
+        // Neighbor::vertex is the source.
+        struct TransposeIndex {
+            std::vector<std::vector<Neighbor>> lists;
+        };
+
+        // Holds the transpose of a graph once it was built. It is built lazily from a const graph,
+        // possibly by several threads at once, so the pointer is only read and written with
+        // atomic_load and atomic_store. A copy of the graph shares the index, so a change updates
+        // it in place only while no other graph holds it, and otherwise drops it.
+        class TransposeCache {
+            private:
+                std::shared_ptr<TransposeIndex> index;
+
+            public:
+                TransposeCache() {}
+                TransposeCache(const TransposeCache& other) : index(std::atomic_load(&other.index)) {}
+                TransposeCache& operator=(const TransposeCache& other) {
+                    std::atomic_store(&index, std::atomic_load(&other.index));
+                    return *this;
+                }
+                std::shared_ptr<const TransposeIndex> get() const { return std::atomic_load(&index); }
+                // Publishes built if no other thread published an index first, and returns the one
+                // that is kept, so all the readers use the same index
+                std::shared_ptr<const TransposeIndex> publish(std::shared_ptr<TransposeIndex> built) {
+                    std::shared_ptr<TransposeIndex> expected;
+                    if (std::atomic_compare_exchange_strong(&index, &expected, built)) {
+                        return built;
+                    }
+                    return expected;
+                }
+                // The index to update for a change of the graph, or null if there is none. An index
+                // that a copy of the graph shares is dropped instead, the copy keeps it as it was.
+                std::shared_ptr<TransposeIndex> exclusive() {
+                    std::shared_ptr<TransposeIndex> current = std::atomic_load(&index);
+                    if (current && current.use_count() > 2) { // held by more than this cache and current
+                        clear();
+                        return std::shared_ptr<TransposeIndex>();
+                    }
+                    return current;
+                }
+                void clear() { std::atomic_store(&index, std::shared_ptr<TransposeIndex>()); }
+        };
+
+        // Holds the connectivity of a graph once it was asked for. Like the transpose it is built
+        // lazily from a const graph, possibly by several threads at once, so the pointer is only
+        // read and written atomically. Unlike the transpose it is then updated in place by the
+        // changes to the graph, so a copy can't share it: a copy starts without it and builds its
+        // own when it needs it, which is cheaper than copying its sets on every copy of the graph.
+        class ConnectivityCache {
+            private:
+                std::shared_ptr<DynamicConnectivity> index;
+
+            public:
+                ConnectivityCache() {}
+                ConnectivityCache(const ConnectivityCache&) {}
+                ConnectivityCache& operator=(const ConnectivityCache&) {
+                    clear();
+                    return *this;
+                }
+                std::shared_ptr<DynamicConnectivity> get() const { return std::atomic_load(&index); }
+                // Publishes built if no other thread published one first, and returns the one that is kept
+                std::shared_ptr<DynamicConnectivity> publish(std::shared_ptr<DynamicConnectivity> built) {
+                    std::shared_ptr<DynamicConnectivity> expected;
+                    if (std::atomic_compare_exchange_strong(&index, &expected, built)) {
+                        return built;
+                    }
+                    return expected;
+                }
+                void clear() { std::atomic_store(&index, std::shared_ptr<DynamicConnectivity>()); }
+        };
+
         class Graph {
             private:
                 std::vector<std::vector<int>> adjacencyMatrix;
+                // The non zero cells of every row, sorted by column. The matrix stays the main storage
+                // and every change to it goes through loadGraph, setEdge, addNode or removeNode, which
+                // update the lists too, so a sparse graph is walked in O(degree) instead of O(n).
+                std::vector<std::vector<Neighbor>> adjacencyLists;
+                // The in-edges, built on the first call to inNeighbors and then updated by the changes
+                mutable TransposeCache transpose;
+                // A number that changes with every change to the edges, see getRevision
+                uint64_t revision = 0;
+                // Connected components of the graph when the edges are taken as undirected. It is built
+                // on the first call to componentCount or sameComponent, and from then on setEdge, addNode
+                // and removeNode keep it updated, also when edges are deleted. loadGraph and loadEmpty
+                // drop it, so a graph that never asks for its components never pays for them.
+                mutable ConnectivityCache components;
+
+                // Facts about the matrix that the algorithms ask for again and again. loadGraph
+                // computes them in one pass and setEdge updates them in O(1) from the old and new
+                // value of the cell, so they never need a scan of the matrix.
+                size_t asymmetricPairs = 0;  // pairs i < j with matrix[i][j] != matrix[j][i]
+                size_t edges = 0;            // non zero cells
+                size_t negativeEdges = 0;
+                size_t selfLoops = 0;
+                size_t nonUnitEdges = 0;     // cells that are neither 0 nor 1
+                std::vector<size_t> outDegrees;
+                std::vector<size_t> inDegrees;
+
+                // Named numbers of every vertex, like its "x" and "y" coordinates. Every vector holds
+                // one value per vertex: addNode appends 0 to each, removeNode drops the last value,
+                // and loadGraph and loadEmpty start a new graph without attributes.
+                std::map<std::string, std::vector<double>> attributes;
+
+                void countCell(int i, int j, int sign);
+                void countPair(int i, int j, int sign);
+                void checkVertex(int v) const;
+                void updateList(int i, int j, int val);
+                void changed();
+                const DynamicConnectivity& connectivity() const;
 
             public:
                 void loadGraph(const std::vector<std::vector<int>>& matrix);
+                void loadEmpty(size_t n);
                 const std::vector<std::vector<int>>& getAdjacencyMatrix() const;
+                NeighborRange neighbors(int u) const;
+                // The edges into v in increasing order of source (Neighbor::vertex is the source).
+                // The first call builds the transpose in O(n + edges), the next ones cost O(in-degree).
+                // setEdge, addNode and removeNode keep it up to date, loadGraph and loadEmpty drop it.
+                // The range is valid until the graph changes.
+                NeighborRange inNeighbors(int v) const;
                 void printGraph() const;
                 bool isEmpty() const;
                 void addNode();
                 void removeNode();
                 void setEdge(int i, int j, int val);
+                // The first call after loadGraph or loadEmpty builds the components in O(n + edges)
+                // set inserts, the next ones are O(1)
+                size_t componentCount() const;
+                bool sameComponent(int u, int v) const;
+                // True once the components were built, so componentCount is O(1)
+                bool hasComponents() const;
+
+                // The cached metadata
+                bool isDirected() const;        // some cell differs from its mirror
+                size_t edgeCount() const;        // an undirected edge counts twice, one per direction
+                size_t negativeEdgeCount() const;
+                size_t selfLoopCount() const;
+                bool hasUnitWeights() const;     // every edge weighs 1
+                size_t outDegree(int v) const;
+                size_t inDegree(int v) const;
+                // Every change to the edges gives the graph a revision no other graph had before, and a
+                // copy keeps the revision of its original until one of them changes. Indexes built
+                // from a graph keep its revision to notice that it changed since.
+                uint64_t getRevision() const;
+
+                // The vertex attributes. setAttribute on a new name creates it with 0 for every vertex.
+                // setAttributes needs one value per vertex and attribute throws out_of_range for a name
+                // that was never set.
+                void setAttribute(const std::string& name, int v, double value);
+                void setAttributes(const std::string& name, const std::vector<double>& values);
+                const std::vector<double>& attribute(const std::string& name) const;
+                bool hasAttribute(const std::string& name) const;
+                std::vector<std::string> attributeNames() const;
+                void removeAttribute(const std::string& name);
 
         };
 }
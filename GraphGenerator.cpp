@@ -0,0 +1,193 @@
+// Mail: tzohary1234@gmail.com
+// Author: Tzohar Lary
+
+#include "GraphGenerator.hpp"
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using namespace ariel;
+
+GraphGenerator::GraphGenerator(unsigned seed, WeightRange weights) : rng(seed), weights(weights) {
+    if (weights.min > weights.max || (weights.min == 0 && weights.max == 0)) {
+        throw invalid_argument("Invalid weight range");
+    }
+}
+
+unsigned GraphGenerator::uniform(unsigned bound) {
+    // 64 bit multiply instead of modulo, no library distribution so the output is portable
+    return (unsigned)(((unsigned long long)rng() * bound) >> 32);
+}
+
+double GraphGenerator::probability() {
+    return rng() / 4294967296.0;
+}
+
+int GraphGenerator::weight() {
+    unsigned range = (unsigned)((long long)weights.max - weights.min + 1);
+    int w = 0;
+    while (w == 0) {
+        w = weights.min + (int)uniform(range);
+    }
+    return w;
+}
+
+void GraphGenerator::addEdge(Graph& g, int u, int v, bool directed) {
+    int w = weight();
+    g.setEdge(u, v, w);
+    if (!directed) {
+        g.setEdge(v, u, w);
+    }
+}
+
+void GraphGenerator::erdosRenyi(Graph& g, size_t n, double p, bool directed) {
+    g.loadEmpty(n);
+    for (size_t i = 0; i < n; ++i) {
+        // an undirected graph draws every pair once
+        for (size_t j = directed ? 0 : i + 1; j < n; ++j) {
+            if (i != j && probability() < p) {
+                addEdge(g, i, j, directed);
+            }
+        }
+    }
+}
+
+void GraphGenerator::rmat(Graph& g, int scale, size_t edgeFactor, double a, double b, double c) {
+    if (scale < 0 || scale > 20 || a + b + c > 1) {
+        throw invalid_argument("Invalid R-MAT parameters");
+    }
+    size_t n = (size_t)1 << scale;
+    g.loadEmpty(n);
+    size_t edges = edgeFactor * n;
+    for (size_t e = 0; e < edges; ++e) {
+        int u = 0;
+        int v = 0;
+        // every level picks one of the four quarters of the current block
+        for (int bit = scale - 1; bit >= 0; --bit) {
+            double r = probability();
+            if (r < a) {
+                // top left
+            } else if (r < a + b) {
+                v |= 1 << bit;
+            } else if (r < a + b + c) {
+                u |= 1 << bit;
+            } else {
+                u |= 1 << bit;
+                v |= 1 << bit;
+            }
+        }
+        if (u != v) {
+            addEdge(g, u, v, true); // repeated edges just get a new weight
+        }
+    }
+}
+
+void GraphGenerator::grid(Graph& g, size_t rows, size_t cols) {
+    g.loadEmpty(rows * cols);
+    for (size_t r = 0; r < rows; ++r) {
+        for (size_t c = 0; c < cols; ++c) {
+            int v = r * cols + c;
+            if (c + 1 < cols) {
+                addEdge(g, v, v + 1, false);
+            }
+            if (r + 1 < rows) {
+                addEdge(g, v, v + cols, false);
+            }
+        }
+    }
+    // the vertices carry their place in the grid, for the coordinate heuristics of aStar
+    vector<double> x(rows * cols);
+    vector<double> y(rows * cols);
+    for (size_t v = 0; v < rows * cols; ++v) {
+        x[v] = v % cols;
+        y[v] = v / cols;
+    }
+    g.setAttributes("x", x);
+    g.setAttributes("y", y);
+}
+
+void GraphGenerator::powerLaw(Graph& g, size_t n, size_t m) {
+    if (m == 0 || n <= m) {
+        throw invalid_argument("Power-law graph needs n > m > 0");
+    }
+    g.loadEmpty(n);
+    // every edge end is written to this list, so a uniform pick from it is proportional to the degree
+    vector<int> ends;
+    // the first m + 1 vertices form a clique to start from
+    for (size_t i = 0; i <= m; ++i) {
+        for (size_t j = i + 1; j <= m; ++j) {
+            addEdge(g, i, j, false);
+            ends.push_back(i);
+            ends.push_back(j);
+        }
+    }
+    const vector<vector<int>>& adj = g.getAdjacencyMatrix();
+    for (size_t v = m + 1; v < n; ++v) {
+        size_t added = 0;
+        while (added < m) {
+            int u = ends[uniform(ends.size())];
+            if (adj[v][u] == 0) {
+                addEdge(g, v, u, false);
+                ends.push_back(u);
+                ++added;
+            }
+        }
+        for (size_t k = 0; k < m; ++k) {
+            ends.push_back(v);
+        }
+    }
+}
+
+void GraphGenerator::bipartite(Graph& g, size_t left, size_t right, double p) {
+    g.loadEmpty(left + right);
+    for (size_t i = 0; i < left; ++i) {
+        for (size_t j = left; j < left + right; ++j) {
+            if (probability() < p) {
+                addEdge(g, i, j, false);
+            }
+        }
+    }
+}
+
+void GraphGenerator::dag(Graph& g, size_t n, double p) {
+    g.loadEmpty(n);
+    // random topological order (Fisher-Yates shuffle)
+    vector<int> order(n);
+    for (size_t i = 0; i < n; ++i) {
+        order[i] = i;
+    }
+    for (size_t i = n; i > 1; --i) {
+        swap(order[i - 1], order[uniform(i)]);
+    }
+    // edges only go forward in the order, so there is no cycle
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = i + 1; j < n; ++j) {
+            if (probability() < p) {
+                addEdge(g, order[i], order[j], true);
+            }
+        }
+    }
+}
+
+void GraphGenerator::plantedNegativeCycle(Graph& g, size_t n, double p, size_t cycleLength) {
+    if (cycleLength < 2 || cycleLength > n) {
+        throw invalid_argument("Invalid cycle length");
+    }
+    if (weights.min <= 0) {
+        throw invalid_argument("The graph around the planted cycle needs positive weights");
+    }
+    erdosRenyi(g, n, p, true);
+    // the cycle goes over random distinct vertices, every edge costs 1 except the
+    // closing edge that makes the total weight -1
+    vector<int> vertices(n);
+    for (size_t i = 0; i < n; ++i) {
+        vertices[i] = i;
+    }
+    for (size_t i = 0; i < cycleLength; ++i) {
+        swap(vertices[i], vertices[i + uniform(n - i)]);
+    }
+    for (size_t i = 0; i + 1 < cycleLength; ++i) {
+        g.setEdge(vertices[i], vertices[i + 1], 1);
+    }
+    g.setEdge(vertices[cycleLength - 1], vertices[0], -(int)cycleLength);
+}
@@ -0,0 +1,56 @@
+// Mail: tzohary1234@gmail.com
+// Author: Tzohar Lary
+
+
+#ifndef GRAPHGENERATOR_HPP
+#define GRAPHGENERATOR_HPP
+
+#include "Graph.hpp"
+#include <random>
+#include <cstddef>
+
+namespace ariel {
+    // The weights of the generated edges are drawn uniformly from [min, max], 0 is skipped
+    // because it means "no edge" in the matrix.
+    struct WeightRange {
+        int min;
+        int max;
+    };
+
+    // Synthetic graphs for the benchmarks and the large tests.
+    // Every generator writes straight into the graph with loadEmpty and setEdge, and the same
+    // seed always gives the same graph (mt19937 is fully specified by the standard and the
+    // numbers are mapped to ranges here, not by the library distributions).
+    class GraphGenerator {
+        private:
+            std::mt19937 rng;
+            WeightRange weights;
+
+            int weight();
+            void addEdge(Graph& g, int u, int v, bool directed);
+
+        public:
+            GraphGenerator(unsigned seed, WeightRange weights = {1, 1});
+            unsigned uniform(unsigned bound);
+            double probability();
+
+            // every pair is an edge with probability p
+            void erdosRenyi(Graph& g, size_t n, double p, bool directed);
+            // R-MAT / Kronecker: 2^scale vertices, edgeFactor * 2^scale directed edges picked by
+            // recursively choosing a quarter of the matrix with probabilities a, b, c, 1-a-b-c
+            void rmat(Graph& g, int scale, size_t edgeFactor, double a = 0.57, double b = 0.19, double c = 0.19);
+            // road-like rows x cols grid, every vertex connected to its 4 neighbors.
+            // Vertex r * cols + c gets the attributes "x" = c and "y" = r.
+            void grid(Graph& g, size_t rows, size_t cols);
+            // power-law degrees by preferential attachment, every new vertex adds m undirected edges
+            void powerLaw(Graph& g, size_t n, size_t m);
+            // two sides of left and right vertices, an undirected edge between them with probability p
+            void bipartite(Graph& g, size_t left, size_t right, double p);
+            // acyclic directed graph, the topological order is shuffled so it's not the index order
+            void dag(Graph& g, size_t n, double p);
+            // positive directed random graph with one planted cycle of the given length whose total weight is negative
+            void plantedNegativeCycle(Graph& g, size_t n, double p, size_t cycleLength);
+    };
+}
+
+#endif // GRAPHGENERATOR_HPP
@@ -0,0 +1,346 @@
+// Mail: tzohary1234@gmail.com
+// Author: Tzohar Lary
+
+
+#include "LandmarkIndex.hpp"
+#include "AlgorithmStats.hpp"
+#include "Workspace.hpp"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <cstring>
+
+using namespace std;
+using namespace ariel;
+
+static const int INF = numeric_limits<int>::max();
+
+// Dijkstra over the in-edges: dist[v] is the distance from v to target
+static void distancesTo(const Graph& g, int target, vector<int>& dist) {
+    typedef pair<int, int> Entry;
+    Workspace ws;
+    vector<Entry>& heap = ws.take<Entry>(0, Entry(0, 0));
+    dist.assign(g.getAdjacencyMatrix().size(), INF);
+    dist[target] = 0;
+    heap.push_back(Entry(0, target));
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end(), greater<Entry>());
+        Entry top = heap.back();
+        heap.pop_back();
+        int v = top.second;
+        if (top.first != dist[v]) continue;
+        for (const Neighbor& e : g.inNeighbors(v)) {
+            if (dist[v] + e.weight < dist[e.vertex]) {
+                dist[e.vertex] = dist[v] + e.weight;
+                heap.push_back(Entry(dist[e.vertex], e.vertex));
+                push_heap(heap.begin(), heap.end(), greater<Entry>());
+            }
+        }
+    }
+}
+
+LandmarkIndex::LandmarkIndex(const Graph& g, size_t k, LandmarkStrategy strategy) {
+    ARIEL_STATS_SCOPE("landmarks");
+    if (g.isEmpty()) {
+        throw invalid_argument("The graph is empty");
+    }
+    if (k == 0) {
+        throw invalid_argument("At least one landmark is needed");
+    }
+    if (g.negativeEdgeCount() > 0) {
+        throw invalid_argument("The graph has negative edges");
+    }
+    n = g.getAdjacencyMatrix().size();
+    revision = g.getRevision();
+    fingerprint = hashGraph(g);
+    directed = g.isDirected();
+    k = min(k, n);
+
+    // the tables of every landmark, interleaved by vertex at the end
+    vector<vector<int>> fromLandmark;
+    vector<vector<int>> toLandmark;
+    vector<bool> chosen(n, false);
+    vector<int> dist;
+    vector<int> parent;
+
+    // The distance from the nearest landmark, INT_MAX when no landmark reaches the vertex.
+    // Before the first landmark it is the distance from vertex 0, so the first pick is far from it.
+    vector<int> nearest;
+    Algorithms::dijkstra(g, 0, nearest, parent);
+    auto farthest = [&]() {
+        int best = -1;
+        for (size_t v = 0; v < n; ++v) {
+            if (!chosen[v] && (best == -1 || nearest[v] > nearest[best])) {
+                best = v;
+            }
+        }
+        return best;
+    };
+
+    // The bound on d(r, v) of the landmarks picked so far
+    auto currentBound = [&](int r, int v) {
+        int best = 0;
+        for (size_t i = 0; i < fromLandmark.size(); ++i) {
+            const vector<int>& f = fromLandmark[i];
+            const vector<int>& t = directed ? toLandmark[i] : fromLandmark[i];
+            if (f[r] != INF && f[v] != INF) {
+                best = max(best, f[v] - f[r]);
+            }
+            if (t[r] != INF && t[v] != INF) {
+                best = max(best, t[r] - t[v]);
+            }
+        }
+        return best;
+    };
+
+    vector<int> order;
+    vector<long long> weight;
+    vector<bool> holdsLandmark;
+    vector<vector<int>> children;
+    while (landmarks.size() < k) {
+        int root = farthest();
+        int next = root;
+        if (strategy == LandmarkStrategy::Avoid) {
+            Algorithms::dijkstra(g, root, dist, parent);
+            order.clear();
+            children.assign(n, vector<int>());
+            for (size_t v = 0; v < n; ++v) {
+                if (dist[v] != INF) {
+                    order.push_back(v);
+                    if (parent[v] != -1) {
+                        children[parent[v]].push_back(v);
+                    }
+                }
+            }
+            // A child is farther than its parent (the weights are positive), so going from the
+            // farthest vertex to the root sees every subtree before the vertex above it. The size of a
+            // subtree is the total error of the current bounds inside it, 0 if it holds a landmark.
+            sort(order.begin(), order.end(), [&](int a, int b) { return dist[a] > dist[b]; });
+            weight.assign(n, 0);
+            holdsLandmark.assign(n, false);
+            for (int v : order) {
+                weight[v] += dist[v] - currentBound(root, v);
+                holdsLandmark[v] = holdsLandmark[v] || chosen[v];
+                if (holdsLandmark[v]) {
+                    weight[v] = 0;
+                }
+                if (parent[v] != -1) {
+                    weight[parent[v]] += weight[v];
+                    holdsLandmark[parent[v]] = holdsLandmark[parent[v]] || holdsLandmark[v];
+                }
+            }
+            // walk down along the heaviest subtree to a leaf
+            int u = root;
+            while (true) {
+                int heaviest = -1;
+                for (int c : children[u]) {
+                    if (weight[c] > 0 && (heaviest == -1 || weight[c] > weight[heaviest])) {
+                        heaviest = c;
+                    }
+                }
+                if (heaviest == -1) {
+                    break;
+                }
+                u = heaviest;
+            }
+            next = u;
+        }
+
+        chosen[next] = true;
+        landmarks.push_back(next);
+        Algorithms::dijkstra(g, next, dist, parent);
+        fromLandmark.push_back(dist);
+        if (directed) {
+            distancesTo(g, next, dist);
+            toLandmark.push_back(dist);
+        }
+        if (landmarks.size() == 1) {
+            nearest = fromLandmark[0];
+        } else {
+            for (size_t v = 0; v < n; ++v) {
+                nearest[v] = min(nearest[v], fromLandmark.back()[v]);
+            }
+        }
+    }
+
+    from.resize(n * k);
+    to.resize(directed ? n * k : 0);
+    for (size_t v = 0; v < n; ++v) {
+        for (size_t i = 0; i < k; ++i) {
+            from[v * k + i] = fromLandmark[i][v];
+            if (directed) {
+                to[v * k + i] = toLandmark[i][v];
+            }
+        }
+    }
+}
+
+size_t LandmarkIndex::size() const {
+    return landmarks.size();
+}
+
+const vector<int>& LandmarkIndex::getLandmarks() const {
+    return landmarks;
+}
+
+void LandmarkIndex::check(const Graph& g) const {
+    if (g.getRevision() != revision) {
+        throw logic_error("The landmark index doesn't match the graph");
+    }
+}
+
+// The bound of landmark i on d(v, t)
+int LandmarkIndex::bound(size_t i, int v, int t) const {
+    size_t k = landmarks.size();
+    int best = 0;
+    // L reaches v but not t, so v can't reach t either
+    int lv = from[v * k + i];
+    int lt = from[t * k + i];
+    if (lv != INF) {
+        if (lt == INF) {
+            return INF;
+        }
+        best = max(best, lt - lv);
+    }
+    // t reaches L but v doesn't, so v can't reach t
+    const vector<int>& back = directed ? to : from;
+    int vl = back[v * k + i];
+    int tl = back[t * k + i];
+    if (tl != INF) {
+        if (vl == INF) {
+            return INF;
+        }
+        best = max(best, vl - tl);
+    }
+    return best;
+}
+
+int LandmarkIndex::lowerBound(int v, int t) const {
+    if (v < 0 || v >= (int)n || t < 0 || t >= (int)n) {
+        throw out_of_range("Index out of range");
+    }
+    int best = 0;
+    for (size_t i = 0; i < landmarks.size(); ++i) {
+        best = max(best, bound(i, v, t));
+    }
+    return best;
+}
+
+PathResult LandmarkIndex::query(const Graph& g, int start, int end, size_t active) const {
+    check(g);
+    if (start < 0 || start >= (int)n || end < 0 || end >= (int)n) {
+        throw out_of_range("Start or end node does not exist");
+    }
+    // The landmarks that bound d(start, end) best are usually the ones behind start or beyond end,
+    // and a few of them give almost the bound of all of them for a fraction of the reads
+    vector<size_t> picked(landmarks.size());
+    vector<int> startBound(landmarks.size());
+    for (size_t i = 0; i < landmarks.size(); ++i) {
+        picked[i] = i;
+        startBound[i] = bound(i, start, end);
+    }
+    stable_sort(picked.begin(), picked.end(), [&](size_t a, size_t b) { return startBound[a] > startBound[b]; });
+    picked.resize(min(picked.size(), max<size_t>(1, active)));
+
+    return Algorithms::aStarSearch(g, start, end, [this, &picked, end](int v) {
+        int best = 0;
+        for (size_t i : picked) {
+            best = max(best, bound(i, v, end));
+        }
+        return (double)best;
+    });
+}
+
+// FNV-1a over the vertex count and every edge
+uint64_t LandmarkIndex::hashGraph(const Graph& g) {
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](uint64_t value) {
+        for (int b = 0; b < 8; ++b) {
+            hash ^= (value >> (8 * b)) & 0xff;
+            hash *= 1099511628211ULL;
+        }
+    };
+    size_t size = g.getAdjacencyMatrix().size();
+    mix(size);
+    for (size_t u = 0; u < size; ++u) {
+        for (const Neighbor& e : g.neighbors(u)) {
+            mix(u);
+            mix(e.vertex);
+            mix((uint32_t)e.weight);
+        }
+    }
+    return hash;
+}
+
+// The file is the magic, then the sizes and the tables as they are in memory
+static const char MAGIC[8] = {'A', 'R', 'I', 'E', 'L', 'A', 'L', 'T'};
+static const uint32_t VERSION = 1;
+
+template <typename T>
+static void writeValue(ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static void readValue(istream& in, T& value) {
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+static void writeInts(ostream& out, const vector<int>& values) {
+    out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(int));
+}
+
+static void readInts(istream& in, vector<int>& values, uint64_t count) {
+    values.resize(count);
+    in.read(reinterpret_cast<char*>(values.data()), count * sizeof(int));
+}
+
+void LandmarkIndex::save(ostream& out) const {
+    out.write(MAGIC, sizeof(MAGIC));
+    writeValue(out, VERSION);
+    writeValue(out, (uint64_t)n);
+    writeValue(out, fingerprint);
+    writeValue(out, (uint8_t)directed);
+    writeValue(out, (uint64_t)landmarks.size());
+    writeInts(out, landmarks);
+    writeInts(out, from);
+    writeInts(out, to);
+    if (!out) {
+        throw runtime_error("Failed to write the landmark index");
+    }
+}
+
+LandmarkIndex LandmarkIndex::load(istream& in, const Graph& g) {
+    char magic[sizeof(MAGIC)];
+    uint32_t version = 0;
+    in.read(magic, sizeof(magic));
+    readValue(in, version);
+    if (!in || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || version != VERSION) {
+        throw runtime_error("Not a landmark index");
+    }
+    LandmarkIndex index;
+    uint64_t size = 0;
+    uint8_t isDirected = 0;
+    uint64_t k = 0;
+    readValue(in, size);
+    readValue(in, index.fingerprint);
+    readValue(in, isDirected);
+    readValue(in, k);
+    if (!in || size != g.getAdjacencyMatrix().size() || index.fingerprint != hashGraph(g)) {
+        throw runtime_error("The landmark index was built for another graph");
+    }
+    if (k == 0 || k > size) {
+        throw runtime_error("Not a landmark index");
+    }
+    index.n = size;
+    index.revision = g.getRevision();
+    index.directed = isDirected != 0;
+    readInts(in, index.landmarks, k);
+    readInts(in, index.from, size * k);
+    readInts(in, index.to, index.directed ? size * k : 0);
+    if (!in) {
+        throw runtime_error("The landmark index is truncated");
+    }
+    return index;
+}
@@ -0,0 +1,72 @@
+// Mail: tzohary1234@gmail.com
+// Author: Tzohar Lary
+
+
+#ifndef LANDMARKINDEX_HPP
+#define LANDMARKINDEX_HPP
+
+#include "Graph.hpp"
+#include "Algorithms.hpp"
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <cstdint>
+
+namespace ariel {
+    // How the landmarks are picked.
+    // Farthest takes every time the vertex farthest from the landmarks picked so far.
+    // Avoid (Goldberg and Werneck) grows a shortest path tree from a vertex far from the landmarks,
+    // weighs every vertex by how much the current bounds underestimate its distance, and walks down
+    // to the leaf of the heaviest subtree without a landmark, so the new landmark covers the
+    // region the others serve worst.
+    enum class LandmarkStrategy {
+        Farthest,
+        Avoid
+    };
+
+    // ALT (A*, landmarks, triangle inequality) preprocessing for point to point queries.
+    // For a landmark L the triangle inequality gives d(v, t) >= d(L, t) - d(L, v) and
+    // d(v, t) >= d(v, L) - d(t, L), so with the distances from and to a few landmarks A* gets a
+    // lower bound for any target without coordinates, and a query settles a small part of the graph.
+    // The weights must not be negative. The index describes the graph as it was when it was built,
+    // after any change to its edges it has to be built again (the queries compare the revision of
+    // the graph and throw logic_error).
+    class LandmarkIndex {
+        private:
+            size_t n = 0;
+            uint64_t revision = 0;      // of the graph the tables were computed for
+            uint64_t fingerprint = 0;   // hash of the edges, checked by load
+            bool directed = false;
+            std::vector<int> landmarks;
+            // d(landmark i, v) is from[v * k + i] and d(v, landmark i) is to[v * k + i], so the bounds
+            // of one vertex are next to each other. INT_MAX is unreachable. An undirected graph has
+            // the same distances both ways and keeps only from.
+            std::vector<int> from;
+            std::vector<int> to;
+
+            LandmarkIndex() {}
+            void check(const Graph& g) const;
+            int bound(size_t i, int v, int t) const;
+            static uint64_t hashGraph(const Graph& g);
+
+        public:
+            // Picks min(k, n) landmarks and computes their distance tables with k (or 2k on a
+            // directed graph) runs of Dijkstra
+            LandmarkIndex(const Graph& g, size_t k, LandmarkStrategy strategy = LandmarkStrategy::Avoid);
+
+            size_t size() const;
+            const std::vector<int>& getLandmarks() const;
+            // The best bound on d(v, t) of all the landmarks, INT_MAX when t can't be reached from v
+            int lowerBound(int v, int t) const;
+            // A* from start to end with the bounds of the active landmarks that give the best bound
+            // for this pair
+            PathResult query(const Graph& g, int start, int end, size_t active = 4) const;
+
+            // A binary file with the tables and a hash of the graph, to keep next to the graph.
+            // load throws runtime_error if the data is not an index or was built for another graph.
+            void save(std::ostream& out) const;
+            static LandmarkIndex load(std::istream& in, const Graph& g);
+    };
+}
+
+#endif // LANDMARKINDEX_HPP
@@ -0,0 +1,198 @@
+// Mail: tzohary1234@gmail.com
+// Author: Tzohar Lary
+
+#include "ShortestPathTree.hpp"
+#include "Algorithms.hpp"
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+using namespace ariel;
+
+static const int INF = numeric_limits<int>::max();
+
+ShortestPathTree::ShortestPathTree(Graph& g, int source) : graph(g), source(source) {
+    if (g.isEmpty()) {
+        throw invalid_argument("The graph is empty");
+    }
+    checkVertex(source);
+    recompute();
+}
+
+void ShortestPathTree::checkVertex(int v) const {
+    int n = graph.getAdjacencyMatrix().size();
+    if (v < 0 || v >= n) {
+        throw invalid_argument("Node does not exist");
+    }
+}
+
+void ShortestPathTree::recompute() {
+    // Label-correcting search (queue based Bellman-Ford) from the source.
+    // A vertex that improves n times is on a negative cycle.
+    int n = graph.getAdjacencyMatrix().size();
+    dist.assign(n, INF);
+    parent.assign(n, -1);
+    inQueue.assign(n, false);
+    affected.reset(n);
+    vector<int> improvements(n, 0);
+
+    queue<int> q;
+    dist[source] = 0;
+    q.push(source);
+    inQueue[source] = true;
+    while (!q.empty()) {
+        int u = q.front();
+        q.pop();
+        inQueue[u] = false;
+        for (const Neighbor& e : graph.neighbors(u)) {
+            int v = e.vertex;
+            if (dist[u] + e.weight < dist[v]) {
+                dist[v] = dist[u] + e.weight;
+                parent[v] = u;
+                if (++improvements[v] >= n) {
+                    throw runtime_error("Graph contains a negative-weight cycle");
+                }
+                if (!inQueue[v]) {
+                    inQueue[v] = true;
+                    q.push(v);
+                }
+            }
+        }
+    }
+}
+
+void ShortestPathTree::propagate(queue<int>& q, int watched) {
+    // Pushes the improvements in the queue forward, only the vertices that improve are visited.
+    // If the watched vertex improves again, its new distance came through itself: a negative cycle.
+    while (!q.empty()) {
+        int u = q.front();
+        q.pop();
+        inQueue[u] = false;
+        if (dist[u] == INF) continue;
+        for (const Neighbor& e : graph.neighbors(u)) {
+            int v = e.vertex;
+            if (dist[u] + e.weight < dist[v]) {
+                if (v == watched) {
+                    while (!q.empty()) {
+                        inQueue[q.front()] = false;
+                        q.pop();
+                    }
+                    throw runtime_error("Graph contains a negative-weight cycle");
+                }
+                dist[v] = dist[u] + e.weight;
+                parent[v] = u;
+                if (!inQueue[v]) {
+                    inQueue[v] = true;
+                    q.push(v);
+                }
+            }
+        }
+    }
+}
+
+void ShortestPathTree::decreaseEdge(int u, int v) {
+    // A cheaper edge can only improve v and the vertices reached through it
+    int w = graph.getAdjacencyMatrix()[u][v];
+    if (dist[u] == INF || dist[u] + w >= dist[v]) {
+        return; // the tree doesn't change
+    }
+    dist[v] = dist[u] + w;
+    parent[v] = u;
+    queue<int> q;
+    q.push(v);
+    inQueue[v] = true;
+    propagate(q, v);
+}
+
+void ShortestPathTree::increaseEdge(int u, int v) {
+    // A more expensive (or deleted) edge matters only if it is a tree edge,
+    // and then only the subtree under v can lose its distances.
+    if (parent[v] != u) {
+        return;
+    }
+
+    // Collect the subtree of v, the children of x are its neighbors whose parent is x
+    vector<int> subtree(1, v);
+    affected.clear();
+    affected.mark(v);
+    for (size_t head = 0; head < subtree.size(); ++head) {
+        int x = subtree[head];
+        for (const Neighbor& e : graph.neighbors(x)) {
+            if (parent[e.vertex] == x && affected.visit(e.vertex)) {
+                subtree.push_back(e.vertex);
+            }
+        }
+    }
+    for (int x : subtree) {
+        dist[x] = INF;
+        parent[x] = -1;
+    }
+
+    // Every vertex of the subtree takes its best edge from outside the subtree
+    for (int x : subtree) {
+        for (const Neighbor& e : graph.inNeighbors(x)) {
+            int y = e.vertex;
+            if (!affected.contains(y) && dist[y] != INF && dist[y] + e.weight < dist[x]) {
+                dist[x] = dist[y] + e.weight;
+                parent[x] = y;
+            }
+        }
+    }
+
+    // Then the distances are corrected inside the subtree
+    queue<int> q;
+    for (int x : subtree) {
+        if (dist[x] != INF) {
+            q.push(x);
+            inQueue[x] = true;
+        }
+    }
+    propagate(q, -1);
+}
+
+void ShortestPathTree::setEdge(int u, int v, int val) {
+    int n = graph.getAdjacencyMatrix().size();
+    if (u < 0 || u >= n || v < 0 || v >= n) {
+        throw out_of_range("Index out of range");
+    }
+    int old = graph.getAdjacencyMatrix()[u][v];
+    if (old == val) {
+        return;
+    }
+    graph.setEdge(u, v, val);
+
+    if (val != 0 && (old == 0 || val < old)) {
+        try {
+            decreaseEdge(u, v);
+        } catch (const runtime_error&) {
+            // the update created a negative cycle, so it is rolled back
+            graph.setEdge(u, v, old);
+            recompute();
+            throw;
+        }
+    } else {
+        increaseEdge(u, v);
+    }
+}
+
+int ShortestPathTree::getSource() const {
+    return source;
+}
+
+int ShortestPathTree::distance(int v) const {
+    checkVertex(v);
+    return dist[v];
+}
+
+int ShortestPathTree::parentOf(int v) const {
+    checkVertex(v);
+    return parent[v];
+}
+
+string ShortestPathTree::pathTo(int v) const {
+    checkVertex(v);
+    if (dist[v] == INF) {
+        return "-1"; // No path found
+    }
+    return Algorithms::pathToString(parent, v);
+}
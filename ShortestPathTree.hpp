@@ -0,0 +1,45 @@
+// Mail: tzohary1234@gmail.com
+// Author: Tzohar Lary
+
+
+#ifndef SHORTESTPATHTREE_HPP
+#define SHORTESTPATHTREE_HPP
+
+#include "Graph.hpp"
+#include "VisitedSet.hpp"
+#include <vector>
+#include <string>
+#include <queue>
+
+namespace ariel {
+    // A shortest path tree from one source that is repaired after every edge update
+    // (Ramalingam-Reps style) instead of being computed again from scratch.
+    // Every cell of the matrix is taken as a directed edge, so an undirected edge is
+    // updated by two setEdge calls. All the edge updates must go through this class,
+    // otherwise the tree doesn't match the graph anymore and recompute() is needed.
+    class ShortestPathTree {
+        private:
+            Graph& graph;
+            int source;
+            std::vector<int> dist;
+            std::vector<int> parent;
+            std::vector<bool> inQueue;   // scratch for propagate, all false between calls
+            VisitedSet affected;         // scratch for increaseEdge, cleared by its epoch
+
+            void checkVertex(int v) const;
+            void propagate(std::queue<int>& q, int watched);
+            void decreaseEdge(int u, int v);
+            void increaseEdge(int u, int v);
+
+        public:
+            ShortestPathTree(Graph& g, int source);
+            void recompute();
+            void setEdge(int u, int v, int val);
+            int getSource() const;
+            int distance(int v) const;
+            int parentOf(int v) const;
+            std::string pathTo(int v) const;
+    };
+}
+
+#endif // SHORTESTPATHTREE_HPP
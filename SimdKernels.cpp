@@ -0,0 +1,470 @@
+// Mail: tzohary1234@gmail.com
+// Author: Tzohar Lary
+
+
+#include "SimdKernels.hpp"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+
+// The vector versions are compiled with target attributes, one function per instruction set,
+// so only the dispatch decides which one runs. Other CPUs use the scalar loops.
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define ARIEL_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace ariel {
+
+// The vector kernels compute saturatingAdd(du, w) as du + clamp(w, lo, hi), which can't
+// overflow and gives INT_MIN or INT_MAX when the real sum is out of range.
+static int saturationLow(int du) {
+    return du < 0 ? INT_MIN - du : INT_MIN;
+}
+
+static int saturationHigh(int du) {
+    return du > 0 ? INT_MAX - du : INT_MAX;
+}
+
+static size_t relaxRowScalar(const int* row, int du, int u, int skip, int* dist, int* parent,
+                             size_t begin, size_t n) {
+    int lo = saturationLow(du);
+    int hi = saturationHigh(du);
+    size_t relaxed = 0;
+    for (size_t v = begin; v < n; ++v) {
+        if (row[v] != 0 && (int)v != skip) {
+            int candidate = du + min(max(row[v], lo), hi);
+            if (dist[v] > candidate) {
+                dist[v] = candidate;
+                parent[v] = u;
+                ++relaxed;
+            }
+        }
+    }
+    return relaxed;
+}
+
+static size_t countNonZeroScalar(const int* row, size_t begin, size_t n) {
+    size_t count = 0;
+    for (size_t v = begin; v < n; ++v) {
+        count += row[v] != 0;
+    }
+    return count;
+}
+
+static bool symmetricRectScalar(const int* const* rows, size_t iBegin, size_t iEnd, size_t jBegin, size_t jEnd) {
+    for (size_t i = iBegin; i < iEnd; ++i) {
+        for (size_t j = jBegin; j < jEnd; ++j) {
+            if (rows[i][j] != rows[j][i]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// The vector versions check the whole blocks of the tile, and these loops the rows and columns left over
+static bool symmetricEdgesScalar(const int* const* rows, size_t i0, size_t j0, size_t height, size_t width,
+                                 size_t blockHeight, size_t blockWidth) {
+    return symmetricRectScalar(rows, i0 + blockHeight, i0 + height, j0, j0 + width) &&
+           symmetricRectScalar(rows, i0, i0 + blockHeight, j0 + blockWidth, j0 + width);
+}
+
+// Adds the entries [begin, n) to stats, which may already hold the vector part of the row
+static void rowStatsScalar(const int* row, size_t begin, size_t n, uint32_t* inDegree, RowStats& stats) {
+    for (size_t v = begin; v < n; ++v) {
+        int w = row[v];
+        if (w != 0) {
+            ++stats.edges;
+            stats.negativeEdges += w < 0;
+            stats.minWeight = min(stats.minWeight, w);
+            stats.maxWeight = max(stats.maxWeight, w);
+            ++inDegree[v];
+        }
+    }
+}
+
+static RowStats emptyRowStats() {
+    RowStats stats;
+    stats.edges = 0;
+    stats.negativeEdges = 0;
+    stats.minWeight = INT_MAX;
+    stats.maxWeight = INT_MIN;
+    return stats;
+}
+
+#ifdef ARIEL_SIMD_X86
+
+__attribute__((target("sse4.1")))
+static size_t relaxRowSSE41(const int* row, int du, int u, int skip, int* dist, int* parent, size_t n) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i vdu = _mm_set1_epi32(du);
+    const __m128i vlo = _mm_set1_epi32(saturationLow(du));
+    const __m128i vhi = _mm_set1_epi32(saturationHigh(du));
+    const __m128i vu = _mm_set1_epi32(u);
+    const __m128i vskip = _mm_set1_epi32(skip);
+    const __m128i step = _mm_set1_epi32(4);
+    __m128i index = _mm_setr_epi32(0, 1, 2, 3);
+    size_t relaxed = 0;
+    size_t v = 0;
+    for (; v + 4 <= n; v += 4, index = _mm_add_epi32(index, step)) {
+        __m128i w = _mm_loadu_si128((const __m128i*)(row + v));
+        __m128i d = _mm_loadu_si128((const __m128i*)(dist + v));
+        __m128i candidate = _mm_add_epi32(vdu, _mm_min_epi32(_mm_max_epi32(w, vlo), vhi));
+        __m128i excluded = _mm_or_si128(_mm_cmpeq_epi32(w, zero), _mm_cmpeq_epi32(index, vskip));
+        __m128i better = _mm_andnot_si128(excluded, _mm_cmpgt_epi32(d, candidate));
+        int bits = _mm_movemask_ps(_mm_castsi128_ps(better));
+        if (bits != 0) {
+            __m128i p = _mm_loadu_si128((const __m128i*)(parent + v));
+            _mm_storeu_si128((__m128i*)(dist + v), _mm_blendv_epi8(d, candidate, better));
+            _mm_storeu_si128((__m128i*)(parent + v), _mm_blendv_epi8(p, vu, better));
+            relaxed += __builtin_popcount(bits);
+        }
+    }
+    return relaxed + relaxRowScalar(row, du, u, skip, dist, parent, v, n);
+}
+
+__attribute__((target("avx2")))
+static size_t relaxRowAVX2(const int* row, int du, int u, int skip, int* dist, int* parent, size_t n) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i vdu = _mm256_set1_epi32(du);
+    const __m256i vlo = _mm256_set1_epi32(saturationLow(du));
+    const __m256i vhi = _mm256_set1_epi32(saturationHigh(du));
+    const __m256i vu = _mm256_set1_epi32(u);
+    const __m256i vskip = _mm256_set1_epi32(skip);
+    const __m256i step = _mm256_set1_epi32(8);
+    __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    size_t relaxed = 0;
+    size_t v = 0;
+    for (; v + 8 <= n; v += 8, index = _mm256_add_epi32(index, step)) {
+        __m256i w = _mm256_loadu_si256((const __m256i*)(row + v));
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dist + v));
+        __m256i candidate = _mm256_add_epi32(vdu, _mm256_min_epi32(_mm256_max_epi32(w, vlo), vhi));
+        __m256i excluded = _mm256_or_si256(_mm256_cmpeq_epi32(w, zero), _mm256_cmpeq_epi32(index, vskip));
+        __m256i better = _mm256_andnot_si256(excluded, _mm256_cmpgt_epi32(d, candidate));
+        int bits = _mm256_movemask_ps(_mm256_castsi256_ps(better));
+        if (bits != 0) {
+            __m256i p = _mm256_loadu_si256((const __m256i*)(parent + v));
+            _mm256_storeu_si256((__m256i*)(dist + v), _mm256_blendv_epi8(d, candidate, better));
+            _mm256_storeu_si256((__m256i*)(parent + v), _mm256_blendv_epi8(p, vu, better));
+            relaxed += __builtin_popcount(bits);
+        }
+    }
+    return relaxed + relaxRowScalar(row, du, u, skip, dist, parent, v, n);
+}
+
+__attribute__((target("avx512f")))
+static size_t relaxRowAVX512(const int* row, int du, int u, int skip, int* dist, int* parent, size_t n) {
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i vdu = _mm512_set1_epi32(du);
+    const __m512i vlo = _mm512_set1_epi32(saturationLow(du));
+    const __m512i vhi = _mm512_set1_epi32(saturationHigh(du));
+    const __m512i vu = _mm512_set1_epi32(u);
+    const __m512i vskip = _mm512_set1_epi32(skip);
+    const __m512i step = _mm512_set1_epi32(16);
+    __m512i index = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    size_t relaxed = 0;
+    size_t v = 0;
+    for (; v + 16 <= n; v += 16, index = _mm512_add_epi32(index, step)) {
+        __m512i w = _mm512_loadu_si512((const void*)(row + v));
+        __m512i d = _mm512_loadu_si512((const void*)(dist + v));
+        __m512i candidate = _mm512_add_epi32(vdu, _mm512_min_epi32(_mm512_max_epi32(w, vlo), vhi));
+        __mmask16 edges = _mm512_cmpneq_epi32_mask(w, zero) & _mm512_cmpneq_epi32_mask(index, vskip);
+        __mmask16 better = _mm512_mask_cmplt_epi32_mask(edges, candidate, d);
+        if (better != 0) {
+            _mm512_mask_storeu_epi32((void*)(dist + v), better, candidate);
+            _mm512_mask_storeu_epi32((void*)(parent + v), better, vu);
+            relaxed += __builtin_popcount(better);
+        }
+    }
+    return relaxed + relaxRowScalar(row, du, u, skip, dist, parent, v, n);
+}
+
+__attribute__((target("sse4.1")))
+static size_t countNonZeroSSE41(const int* row, size_t n) {
+    const __m128i zero = _mm_setzero_si128();
+    size_t zeros = 0;
+    size_t v = 0;
+    for (; v + 4 <= n; v += 4) {
+        __m128i w = _mm_loadu_si128((const __m128i*)(row + v));
+        zeros += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(w, zero))));
+    }
+    return v - zeros + countNonZeroScalar(row, v, n);
+}
+
+__attribute__((target("avx2")))
+static size_t countNonZeroAVX2(const int* row, size_t n) {
+    const __m256i zero = _mm256_setzero_si256();
+    size_t zeros = 0;
+    size_t v = 0;
+    for (; v + 8 <= n; v += 8) {
+        __m256i w = _mm256_loadu_si256((const __m256i*)(row + v));
+        zeros += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(w, zero))));
+    }
+    return v - zeros + countNonZeroScalar(row, v, n);
+}
+
+__attribute__((target("avx512f")))
+static size_t countNonZeroAVX512(const int* row, size_t n) {
+    const __m512i zero = _mm512_setzero_si512();
+    size_t count = 0;
+    size_t v = 0;
+    for (; v + 16 <= n; v += 16) {
+        __m512i w = _mm512_loadu_si512((const void*)(row + v));
+        count += __builtin_popcount(_mm512_cmpneq_epi32_mask(w, zero));
+    }
+    return count + countNonZeroScalar(row, v, n);
+}
+
+__attribute__((target("sse4.1")))
+static bool symmetricTileSSE41(const int* const* rows, size_t i0, size_t j0, size_t height, size_t width) {
+    size_t blockHeight = height - height % 4;
+    size_t blockWidth = width - width % 4;
+    for (size_t i = i0; i < i0 + blockHeight; i += 4) {
+        for (size_t j = j0; j < j0 + blockWidth; j += 4) {
+            __m128 c0 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(rows[j] + i)));
+            __m128 c1 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(rows[j + 1] + i)));
+            __m128 c2 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(rows[j + 2] + i)));
+            __m128 c3 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(rows[j + 3] + i)));
+            _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+            __m128i diff = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(rows[i] + j)), _mm_castps_si128(c0));
+            diff = _mm_or_si128(diff, _mm_xor_si128(_mm_loadu_si128((const __m128i*)(rows[i + 1] + j)), _mm_castps_si128(c1)));
+            diff = _mm_or_si128(diff, _mm_xor_si128(_mm_loadu_si128((const __m128i*)(rows[i + 2] + j)), _mm_castps_si128(c2)));
+            diff = _mm_or_si128(diff, _mm_xor_si128(_mm_loadu_si128((const __m128i*)(rows[i + 3] + j)), _mm_castps_si128(c3)));
+            if (!_mm_testz_si128(diff, diff)) {
+                return false;
+            }
+        }
+    }
+    return symmetricEdgesScalar(rows, i0, j0, height, width, blockHeight, blockWidth);
+}
+
+// The shuffles of an 8x8 transpose work on floats, but they only move the bits of the ints.
+// Everything is written out so the eight rows stay in registers even without -O3.
+__attribute__((target("avx2")))
+static inline __m256i loadRow(const int* row) {
+    return _mm256_loadu_si256((const __m256i*)row);
+}
+
+__attribute__((target("avx2")))
+static bool symmetricTileAVX2(const int* const* rows, size_t i0, size_t j0, size_t height, size_t width) {
+    size_t blockHeight = height - height % 8;
+    size_t blockWidth = width - width % 8;
+    for (size_t i = i0; i < i0 + blockHeight; i += 8) {
+        for (size_t j = j0; j < j0 + blockWidth; j += 8) {
+            __m256 c0 = _mm256_castsi256_ps(loadRow(rows[j] + i));
+            __m256 c1 = _mm256_castsi256_ps(loadRow(rows[j + 1] + i));
+            __m256 c2 = _mm256_castsi256_ps(loadRow(rows[j + 2] + i));
+            __m256 c3 = _mm256_castsi256_ps(loadRow(rows[j + 3] + i));
+            __m256 c4 = _mm256_castsi256_ps(loadRow(rows[j + 4] + i));
+            __m256 c5 = _mm256_castsi256_ps(loadRow(rows[j + 5] + i));
+            __m256 c6 = _mm256_castsi256_ps(loadRow(rows[j + 6] + i));
+            __m256 c7 = _mm256_castsi256_ps(loadRow(rows[j + 7] + i));
+
+            __m256 t0 = _mm256_unpacklo_ps(c0, c1);
+            __m256 t1 = _mm256_unpackhi_ps(c0, c1);
+            __m256 t2 = _mm256_unpacklo_ps(c2, c3);
+            __m256 t3 = _mm256_unpackhi_ps(c2, c3);
+            __m256 t4 = _mm256_unpacklo_ps(c4, c5);
+            __m256 t5 = _mm256_unpackhi_ps(c4, c5);
+            __m256 t6 = _mm256_unpacklo_ps(c6, c7);
+            __m256 t7 = _mm256_unpackhi_ps(c6, c7);
+
+            __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+            __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+            __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+            __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+            __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+            __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+            __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+            __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+            // row k of the transposed block is column k of the mirror block
+            __m256i diff = _mm256_xor_si256(loadRow(rows[i] + j), _mm256_castps_si256(_mm256_permute2f128_ps(s0, s4, 0x20)));
+            diff = _mm256_or_si256(diff, _mm256_xor_si256(loadRow(rows[i + 1] + j), _mm256_castps_si256(_mm256_permute2f128_ps(s1, s5, 0x20))));
+            diff = _mm256_or_si256(diff, _mm256_xor_si256(loadRow(rows[i + 2] + j), _mm256_castps_si256(_mm256_permute2f128_ps(s2, s6, 0x20))));
+            diff = _mm256_or_si256(diff, _mm256_xor_si256(loadRow(rows[i + 3] + j), _mm256_castps_si256(_mm256_permute2f128_ps(s3, s7, 0x20))));
+            diff = _mm256_or_si256(diff, _mm256_xor_si256(loadRow(rows[i + 4] + j), _mm256_castps_si256(_mm256_permute2f128_ps(s0, s4, 0x31))));
+            diff = _mm256_or_si256(diff, _mm256_xor_si256(loadRow(rows[i + 5] + j), _mm256_castps_si256(_mm256_permute2f128_ps(s1, s5, 0x31))));
+            diff = _mm256_or_si256(diff, _mm256_xor_si256(loadRow(rows[i + 6] + j), _mm256_castps_si256(_mm256_permute2f128_ps(s2, s6, 0x31))));
+            diff = _mm256_or_si256(diff, _mm256_xor_si256(loadRow(rows[i + 7] + j), _mm256_castps_si256(_mm256_permute2f128_ps(s3, s7, 0x31))));
+            if (!_mm256_testz_si256(diff, diff)) {
+                return false;
+            }
+        }
+    }
+    return symmetricEdgesScalar(rows, i0, j0, height, width, blockHeight, blockWidth);
+}
+
+__attribute__((target("sse4.1")))
+static RowStats rowStatsSSE41(const int* row, size_t n, uint32_t* inDegree) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi32(-1);
+    __m128i low = _mm_set1_epi32(INT_MAX);
+    __m128i high = _mm_set1_epi32(INT_MIN);
+    RowStats stats = emptyRowStats();
+    size_t v = 0;
+    for (; v + 4 <= n; v += 4) {
+        __m128i w = _mm_loadu_si128((const __m128i*)(row + v));
+        __m128i missing = _mm_cmpeq_epi32(w, zero);
+        stats.edges += 4 - __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(missing)));
+        stats.negativeEdges += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(w)));
+        low = _mm_min_epi32(low, _mm_blendv_epi8(w, _mm_set1_epi32(INT_MAX), missing));
+        high = _mm_max_epi32(high, _mm_blendv_epi8(w, _mm_set1_epi32(INT_MIN), missing));
+        // an edge is -1 in the compare mask, so subtracting the mask adds one
+        __m128i degree = _mm_loadu_si128((const __m128i*)(inDegree + v));
+        _mm_storeu_si128((__m128i*)(inDegree + v), _mm_sub_epi32(degree, _mm_xor_si128(missing, ones)));
+    }
+    int lanes[4];
+    _mm_storeu_si128((__m128i*)lanes, low);
+    stats.minWeight = min(min(lanes[0], lanes[1]), min(lanes[2], lanes[3]));
+    _mm_storeu_si128((__m128i*)lanes, high);
+    stats.maxWeight = max(max(lanes[0], lanes[1]), max(lanes[2], lanes[3]));
+    rowStatsScalar(row, v, n, inDegree, stats);
+    return stats;
+}
+
+__attribute__((target("avx2")))
+static RowStats rowStatsAVX2(const int* row, size_t n, uint32_t* inDegree) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ones = _mm256_set1_epi32(-1);
+    __m256i low = _mm256_set1_epi32(INT_MAX);
+    __m256i high = _mm256_set1_epi32(INT_MIN);
+    RowStats stats = emptyRowStats();
+    size_t v = 0;
+    for (; v + 8 <= n; v += 8) {
+        __m256i w = loadRow(row + v);
+        __m256i missing = _mm256_cmpeq_epi32(w, zero);
+        stats.edges += 8 - __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(missing)));
+        stats.negativeEdges += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(w)));
+        low = _mm256_min_epi32(low, _mm256_blendv_epi8(w, _mm256_set1_epi32(INT_MAX), missing));
+        high = _mm256_max_epi32(high, _mm256_blendv_epi8(w, _mm256_set1_epi32(INT_MIN), missing));
+        __m256i degree = _mm256_loadu_si256((const __m256i*)(inDegree + v));
+        _mm256_storeu_si256((__m256i*)(inDegree + v), _mm256_sub_epi32(degree, _mm256_xor_si256(missing, ones)));
+    }
+    int lanes[8];
+    _mm256_storeu_si256((__m256i*)lanes, low);
+    stats.minWeight = *min_element(lanes, lanes + 8);
+    _mm256_storeu_si256((__m256i*)lanes, high);
+    stats.maxWeight = *max_element(lanes, lanes + 8);
+    rowStatsScalar(row, v, n, inDegree, stats);
+    return stats;
+}
+
+#endif // ARIEL_SIMD_X86
+
+SimdLevel SimdKernels::detect() {
+#ifdef ARIEL_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return SimdLevel::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return SimdLevel::SSE41;
+    }
+#endif
+    return SimdLevel::Scalar;
+}
+
+static SimdLevel initialLevel() {
+    SimdLevel best = SimdKernels::detect();
+    const char* env = getenv("ARIEL_SIMD");
+    if (env == nullptr) {
+        return best;
+    }
+    SimdLevel requested = best;
+    if (strcmp(env, "scalar") == 0) {
+        requested = SimdLevel::Scalar;
+    } else if (strcmp(env, "sse4.1") == 0) {
+        requested = SimdLevel::SSE41;
+    } else if (strcmp(env, "avx2") == 0) {
+        requested = SimdLevel::AVX2;
+    }
+    return min(requested, best);
+}
+
+// The level is read by every kernel call, from any thread
+static atomic<int>& activeLevel() {
+    static atomic<int> active(static_cast<int>(initialLevel()));
+    return active;
+}
+
+SimdLevel SimdKernels::level() {
+    return static_cast<SimdLevel>(activeLevel().load(memory_order_relaxed));
+}
+
+SimdLevel SimdKernels::setLevel(SimdLevel requested) {
+    SimdLevel used = min(requested, detect());
+    activeLevel().store(static_cast<int>(used), memory_order_relaxed);
+    return used;
+}
+
+const char* SimdKernels::levelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::SSE41: return "sse4.1";
+        case SimdLevel::AVX2: return "avx2";
+        case SimdLevel::AVX512: return "avx512";
+        default: return "scalar";
+    }
+}
+
+size_t SimdKernels::relaxRow(const int* row, int du, int u, int skip, int* dist, int* parent, size_t n) {
+#ifdef ARIEL_SIMD_X86
+    switch (level()) {
+        case SimdLevel::AVX512: return relaxRowAVX512(row, du, u, skip, dist, parent, n);
+        case SimdLevel::AVX2: return relaxRowAVX2(row, du, u, skip, dist, parent, n);
+        case SimdLevel::SSE41: return relaxRowSSE41(row, du, u, skip, dist, parent, n);
+        default: break;
+    }
+#endif
+    return relaxRowScalar(row, du, u, skip, dist, parent, 0, n);
+}
+
+bool SimdKernels::symmetricTile(const int* const* rows, size_t i0, size_t j0, size_t height, size_t width) {
+#ifdef ARIEL_SIMD_X86
+    switch (level()) {
+        // an 8x8 block is already a whole cache line per row, AVX-512 uses the AVX2 version
+        case SimdLevel::AVX512:
+        case SimdLevel::AVX2: return symmetricTileAVX2(rows, i0, j0, height, width);
+        case SimdLevel::SSE41: return symmetricTileSSE41(rows, i0, j0, height, width);
+        default: break;
+    }
+#endif
+    return symmetricRectScalar(rows, i0, i0 + height, j0, j0 + width);
+}
+
+// AVX-512 runs the AVX2 version of this scan, which is already limited by memory
+RowStats SimdKernels::rowStats(const int* row, size_t n, uint32_t* inDegree) {
+#ifdef ARIEL_SIMD_X86
+    switch (level()) {
+        case SimdLevel::AVX512:
+        case SimdLevel::AVX2: return rowStatsAVX2(row, n, inDegree);
+        case SimdLevel::SSE41: return rowStatsSSE41(row, n, inDegree);
+        default: break;
+    }
+#endif
+    RowStats stats = emptyRowStats();
+    rowStatsScalar(row, 0, n, inDegree, stats);
+    return stats;
+}
+
+size_t SimdKernels::countNonZero(const int* row, size_t n) {
+#ifdef ARIEL_SIMD_X86
+    switch (level()) {
+        case SimdLevel::AVX512: return countNonZeroAVX512(row, n);
+        case SimdLevel::AVX2: return countNonZeroAVX2(row, n);
+        case SimdLevel::SSE41: return countNonZeroSSE41(row, n);
+        default: break;
+    }
+#endif
+    return countNonZeroScalar(row, 0, n);
+}
+
+}
@@ -0,0 +1,80 @@
+// Mail: tzohary1234@gmail.com
+// Author: Tzohar Lary
+
+
+#ifndef SIMDKERNELS_HPP
+#define SIMDKERNELS_HPP
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+
+namespace ariel {
+    // The instruction sets the kernels are written for, from the slowest to the fastest.
+    enum class SimdLevel {
+        Scalar,
+        SSE41,
+        AVX2,
+        AVX512
+    };
+
+    // What rowStats finds in one row. The weights are of the non zero entries only,
+    // minWeight is INT_MAX and maxWeight is INT_MIN when the row has no edges.
+    struct RowStats {
+        size_t edges;
+        size_t negativeEdges;
+        int minWeight;
+        int maxWeight;
+    };
+
+    // Vectorized inner loops of the algorithms over the rows of the adjacency matrix.
+    // Every kernel is compiled for all the levels and the best one the CPU supports is
+    // picked at runtime, so the library doesn't need -march flags to use them.
+    // All the levels give exactly the same results as the scalar loop.
+    class SimdKernels {
+        public:
+            // The best level of this CPU
+            static SimdLevel detect();
+            // The level the kernels run with. It starts as detect(), or lower if the
+            // ARIEL_SIMD environment variable asks for it (scalar, sse4.1, avx2, avx512).
+            static SimdLevel level();
+            // Runs the kernels with the given level, or the best supported level below it.
+            // Returns the level that is used.
+            static SimdLevel setLevel(SimdLevel requested);
+            static const char* levelName(SimdLevel level);
+
+            // du + w clamped to INT_MIN and INT_MAX instead of overflowing. The sparse rows of
+            // relax and the Goldberg-Radzik passes add with it too, so every path of Bellman-Ford
+            // gives the same distances.
+            static int saturatingAdd(int du, int w) {
+                if (du > 0 && w > INT_MAX - du) {
+                    return INT_MAX;
+                }
+                if (du < 0 && w < INT_MIN - du) {
+                    return INT_MIN;
+                }
+                return du + w;
+            }
+
+            // One Bellman-Ford step from vertex u: for every v with row[v] != 0 and v != skip,
+            // if du + row[v] < dist[v] then dist[v] = du + row[v] and parent[v] = u.
+            // The sum is saturatingAdd(du, row[v]), so it never wraps around to a small distance.
+            // row[u] must not be negative (a negative self loop changes du in the middle of the row).
+            // Returns the number of improved vertices.
+            static size_t relaxRow(const int* row, int du, int u, int skip, int* dist, int* parent, size_t n);
+
+            // The number of non zero entries of a row (the edges it holds)
+            static size_t countNonZero(const int* row, size_t n);
+
+            // The edges, negative edges and weight range of a row, in one pass.
+            // inDegree[v] is increased by one for every edge of the row to v.
+            static RowStats rowStats(const int* row, size_t n, uint32_t* inDegree);
+
+            // Checks rows[i][j] == rows[j][i] for every i in [i0, i0 + height) and j in [j0, j0 + width).
+            // The vector versions load 8x8 (or 4x4) blocks of both sides and transpose one of them
+            // in registers, so both sides are read along their rows.
+            static bool symmetricTile(const int* const* rows, size_t i0, size_t j0, size_t height, size_t width);
+    };
+}
+
+#endif // SIMDKERNELS_HPP
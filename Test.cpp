@@ -4,6 +4,24 @@
 #include "doctest.h"
 #include "Algorithms.hpp"
 #include "Graph.hpp"
+#include "ShortestPathTree.hpp"
+#include "GraphGenerator.hpp"
+#include "AlgorithmStats.hpp"
+#include "VersionedGraph.hpp"
+#include "ThreadPool.hpp"
+#include "VertexOrder.hpp"
+#include "Workspace.hpp"
+#include "VisitedSet.hpp"
+#include "EpochArray.hpp"
+#include "SimdKernels.hpp"
+#include "LandmarkIndex.hpp"
+#include <limits>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <random>
 
 using namespace std;
 
@@ -452,3 +470,2015 @@ TEST_CASE("Test invalid graph")
 
 }
 
+TEST_CASE("Test shortestPath with Goldberg-Radzik engine")
+{
+    ariel::Graph g;
+    ariel::ShortestPathEngine gr = ariel::ShortestPathEngine::GoldbergRadzik;
+
+    SUBCASE("DAG given in reverse index order") {
+        vector<vector<int>> graph = {
+            {0, 0, 0, 0},
+            {7, 0, 0, 0},
+            {0, 2, 0, 0},
+            {9, 0, 3, 0}};
+        g.loadGraph(graph);
+        CHECK(ariel::Algorithms::shortestPath(g, 3, 0, gr) == "3->0");
+        CHECK(ariel::Algorithms::shortestPath(g, 3, 1, gr) == "3->2->1");
+
+        // one pass, even though every edge goes from a larger index to a smaller one
+        const int INF = numeric_limits<int>::max();
+        vector<int> dist(4, INF);
+        vector<int> parent(4, -1);
+        dist[3] = 0;
+        CHECK(ariel::Algorithms::goldbergRadzik(g, dist, parent) == 1);
+        CHECK(dist == vector<int>({9, 5, 3, 0}));
+        // nothing left to improve
+        CHECK(ariel::Algorithms::goldbergRadzik(g, dist, parent) == 0);
+    }
+
+    SUBCASE("One pass on shuffled DAGs") {
+        const int INF = numeric_limits<int>::max();
+        ariel::GraphGenerator positive(41, ariel::WeightRange{1, 50});
+        ariel::GraphGenerator mixed(42, ariel::WeightRange{-20, 50});
+        for (ariel::GraphGenerator* gen : {&positive, &mixed}) {
+            gen->dag(g, 80, 0.1);
+            for (int source : {0, 17, 79}) {
+                vector<int> dist(80, INF);
+                vector<int> parent(80, -1);
+                dist[source] = 0;
+                vector<int> expected = dist;
+                ariel::Algorithms::bellmanFord(g, expected);
+                CHECK(ariel::Algorithms::goldbergRadzik(g, dist, parent) <= 1);
+                CHECK(dist == expected);
+            }
+            // every vertex starts at 0, like the negative cycle search
+            vector<int> dist(80, 0);
+            vector<int> parent(80, -1);
+            vector<int> expected = dist;
+            ariel::Algorithms::bellmanFord(g, expected);
+            CHECK(ariel::Algorithms::goldbergRadzik(g, dist, parent) <= 1);
+            CHECK(dist == expected);
+        }
+    }
+
+    SUBCASE("Same answers as Bellman-Ford") {
+        vector<vector<int>> graph = {
+            {0, 1, 0, 0, 0},
+            {1, 0, 3, 0, 0},
+            {0, 3, 0, 4, 0},
+            {0, 0, 4, 0, 5},
+            {0, 0, 0, 5, 0}};
+        g.loadGraph(graph);
+        CHECK(ariel::Algorithms::shortestPath(g, 0, 4, gr) == ariel::Algorithms::shortestPath(g, 0, 4));
+        CHECK(ariel::Algorithms::shortestPath(g, 4, 1, gr) == ariel::Algorithms::shortestPath(g, 4, 1));
+    }
+
+    SUBCASE("Negative edge but no negative cycle") {
+        vector<vector<int>> graph = {
+            {0, -1, 0, 0, 0},
+            {0, 0, 3, 0, 0},
+            {0, 3, 0, 4, 0},
+            {0, 0, 4, 0, 5},
+            {0, 0, 0, 5, 0}};
+        g.loadGraph(graph);
+        CHECK(ariel::Algorithms::shortestPath(g, 0, 4, gr) == "0->1->2->3->4");
+    }
+
+    SUBCASE("Negative cycle") {
+        vector<vector<int>> graph = {
+            {0, 1, -1, 0, 0},
+            {0, 0, -3, 0, 0},
+            {-1, -3, 0, 4, 0},
+            {0, 0, 4, 0, 5},
+            {0, 0, 0, 5, 0}};
+        g.loadGraph(graph);
+        CHECK_THROWS(ariel::Algorithms::shortestPath(g, 0, 4, gr));
+        vector<int> dist(5, numeric_limits<int>::max());
+        dist[0] = 0;
+        CHECK(ariel::Algorithms::bellmanFord(g, dist, gr) == true);
+    }
+}
+
+TEST_CASE("Test parity union-find")
+{
+    SUBCASE("Even cycle stays bipartite") {
+        ariel::DisjointSet sides(4);
+        CHECK(sides.addEdge(0, 1) == true);
+        CHECK(sides.addEdge(1, 2) == true);
+        CHECK(sides.addEdge(2, 3) == true);
+        CHECK(sides.addEdge(3, 0) == true);
+        CHECK(sides.sameSide(0, 2) == true);
+        CHECK(sides.sameSide(0, 3) == false);
+        CHECK(sides.componentCount() == 1);
+    }
+
+    SUBCASE("Odd cycle is found when the closing edge arrives") {
+        ariel::DisjointSet sides(3);
+        CHECK(sides.addEdge(0, 1) == true);
+        CHECK(sides.addEdge(1, 2) == true);
+        CHECK(sides.addEdge(2, 0) == false);
+        CHECK(sides.isBipartite() == false);
+    }
+
+    SUBCASE("Vertices added while edges arrive") {
+        ariel::DisjointSet sides;
+        int a = sides.addVertex();
+        int b = sides.addVertex();
+        CHECK(sides.componentCount() == 2);
+        sides.addEdge(a, b);
+        int c = sides.addVertex();
+        CHECK(sides.addEdge(c, a) == true);
+        CHECK(sides.sameSide(b, c) == true);
+        CHECK_THROWS(sides.find(5));
+    }
+
+    SUBCASE("Edge stream check") {
+        vector<pair<int, int>> edges = {{0, 1}, {1, 2}, {2, 3}, {4, 5}};
+        CHECK(ariel::Algorithms::isBipartiteStream(6, edges) == true);
+        edges.push_back({3, 1});
+        CHECK(ariel::Algorithms::isBipartiteStream(6, edges) == false);
+    }
+}
+
+TEST_CASE("Test incremental connectivity")
+{
+    ariel::Graph g;
+    vector<vector<int>> graph = {
+        {0, 0, 0, 0},
+        {0, 0, 0, 0},
+        {0, 0, 0, 0},
+        {0, 0, 0, 0}};
+    g.loadGraph(graph);
+    CHECK(g.componentCount() == 4);
+
+    SUBCASE("Edges are added one by one") {
+        g.setEdge(0, 1, 1);
+        g.setEdge(1, 0, 1);
+        CHECK(g.componentCount() == 3);
+        CHECK(g.sameComponent(0, 1) == true);
+        g.setEdge(2, 3, 4);
+        g.setEdge(3, 2, 4);
+        g.setEdge(1, 2, 2);
+        g.setEdge(2, 1, 2);
+        CHECK(g.componentCount() == 1);
+        CHECK(ariel::Algorithms::isConnected(g) == true);
+    }
+
+    SUBCASE("Added node starts as its own component") {
+        g.addNode();
+        CHECK(g.componentCount() == 5);
+        g.setEdge(4, 0, 1);
+        CHECK(g.sameComponent(0, 4) == true);
+        CHECK_THROWS(g.sameComponent(0, 5));
+    }
+
+    SUBCASE("Deleting an edge updates the components") {
+        g.setEdge(0, 1, 1);
+        g.setEdge(1, 0, 1);
+        g.setEdge(0, 1, 0);
+        CHECK(g.sameComponent(0, 1) == true); // the edge 1->0 still connects them
+        g.setEdge(1, 0, 0);
+        CHECK(g.sameComponent(0, 1) == false);
+        CHECK(g.componentCount() == 4);
+    }
+
+    SUBCASE("Built on demand and not copied") {
+        vector<vector<int>> path = {
+            {0, 1, 0},
+            {0, 0, 0},
+            {0, 2, 0}};
+        g.loadGraph(path);
+        CHECK(g.hasComponents() == false);
+        CHECK(ariel::Algorithms::isConnected(g) == false); // directed, answered by searches
+        g.setEdge(0, 1, 0);
+        CHECK(g.componentCount() == 2);    // built here, from the edges 2->1 only
+        CHECK(g.hasComponents() == true);
+        ariel::Graph copy = g;
+        CHECK(copy.hasComponents() == false);
+        copy.setEdge(0, 2, 3);
+        CHECK(copy.componentCount() == 1);
+        CHECK(g.componentCount() == 2);   // the original didn't see the change of the copy
+        g.setEdge(1, 0, 1);
+        CHECK(g.componentCount() == 1);   // and keeps its own updated
+        g.loadGraph(path);
+        CHECK(g.hasComponents() == false);
+    }
+}
+
+TEST_CASE("Test dynamic connectivity")
+{
+    SUBCASE("Deleted tree edge is replaced by a non-tree edge") {
+        ariel::DynamicConnectivity dc(4);
+        dc.insertEdge(0, 1);
+        dc.insertEdge(1, 2);
+        dc.insertEdge(2, 3);
+        dc.insertEdge(3, 0); // closes a cycle, kept as a non-tree edge
+        CHECK(dc.componentCount() == 1);
+        dc.deleteEdge(1, 2);
+        CHECK(dc.componentCount() == 1);
+        CHECK(dc.connected(1, 2) == true);
+        dc.deleteEdge(3, 0);
+        CHECK(dc.componentCount() == 2);
+        CHECK(dc.connected(0, 1) == true);
+        CHECK(dc.connected(1, 2) == false);
+        CHECK(dc.connected(2, 3) == true);
+    }
+
+    SUBCASE("Graph keeps the components after setEdge and removeNode") {
+        ariel::Graph g;
+        vector<vector<int>> graph = {
+            {0, 1, 0, 0},
+            {1, 0, 1, 0},
+            {0, 1, 0, 1},
+            {0, 0, 1, 0}};
+        g.loadGraph(graph);
+        CHECK(ariel::Algorithms::isConnected(g) == true);
+        g.setEdge(1, 2, 0);
+        g.setEdge(2, 1, 0);
+        CHECK(g.componentCount() == 2);
+        CHECK(ariel::Algorithms::isConnected(g) == false);
+        g.setEdge(0, 3, 5);
+        g.setEdge(3, 0, 5);
+        CHECK(ariel::Algorithms::isConnected(g) == true);
+        g.removeNode(); // node 3 held the two halves together
+        CHECK(g.componentCount() == 2);
+        CHECK(g.sameComponent(1, 2) == false);
+    }
+
+    SUBCASE("Same answers as a BFS after many updates") {
+        const int n = 24;
+        ariel::DynamicConnectivity dc(n);
+        vector<vector<bool>> adj(n, vector<bool>(n, false));
+        auto matchesBFS = [&]() {
+            vector<int> comp(n, -1);
+            size_t count = 0;
+            for (int s = 0; s < n; ++s) {
+                if (comp[s] != -1) continue;
+                vector<int> q(1, s);
+                comp[s] = count;
+                for (size_t head = 0; head < q.size(); ++head) {
+                    for (int y = 0; y < n; ++y) {
+                        if (adj[q[head]][y] && comp[y] == -1) {
+                            comp[y] = count;
+                            q.push_back(y);
+                        }
+                    }
+                }
+                ++count;
+            }
+            bool same = dc.componentCount() == count;
+            for (int u = 0; u < n; ++u) {
+                for (int v = 0; v < n; ++v) {
+                    same = same && dc.connected(u, v) == (comp[u] == comp[v]);
+                }
+            }
+            return same;
+        };
+        unsigned seed = 7;
+        bool same = true;
+        for (int step = 0; step < 4000; ++step) {
+            seed = seed * 1103515245u + 12345u;
+            int u = (seed >> 8) % n;
+            int v = (seed >> 16) % n;
+            if (u == v) continue;
+            if (adj[u][v]) {
+                dc.deleteEdge(u, v);
+            } else {
+                dc.insertEdge(u, v);
+            }
+            adj[u][v] = adj[v][u] = !adj[u][v];
+            if (step % 25 == 0) {
+                same = same && matchesBFS();
+            }
+        }
+        CHECK(same);
+        CHECK(matchesBFS());
+    }
+
+    SUBCASE("Edges scanned inside a side move up a level") {
+        // a clique of 4 and a clique of 8 joined by the bridge 3-4
+        ariel::DynamicConnectivity dc(12);
+        auto clique = [&dc](int first, int last) {
+            for (int u = first; u <= last; ++u) {
+                for (int v = u + 1; v <= last; ++v) {
+                    dc.insertEdge(u, v);
+                }
+            }
+        };
+        clique(0, 3);
+        clique(4, 11);
+        dc.insertEdge(3, 4);
+        CHECK(dc.edgeLevel(3, 4) == 0);
+        CHECK(dc.edgeLevel(0, 1) == 0);
+        dc.deleteEdge(3, 4);
+        CHECK(dc.componentCount() == 2);
+        // the small clique was searched and all of its edges moved up, so deleting the
+        // bridge again doesn't scan them
+        for (int u = 0; u < 4; ++u) {
+            for (int v = u + 1; v < 4; ++v) {
+                CHECK(dc.edgeLevel(u, v) == 1);
+            }
+        }
+        CHECK(dc.edgeLevel(4, 5) == 0);
+        dc.insertEdge(3, 4);
+        CHECK(dc.componentCount() == 1);
+        dc.deleteEdge(3, 4);
+        CHECK(dc.componentCount() == 2);
+        CHECK(dc.edgeLevel(3, 4) == -1);
+        CHECK_THROWS_AS(dc.edgeLevel(0, 12), std::out_of_range);
+
+        // the edges of level 1 still replace each other
+        dc.deleteEdge(0, 1);
+        dc.deleteEdge(0, 2);
+        CHECK(dc.connected(0, 1) == true);
+        dc.deleteEdge(0, 3);
+        CHECK(dc.connected(0, 1) == false);
+        CHECK(dc.componentCount() == 3);
+    }
+}
+
+TEST_CASE("Test shortest path tree repair")
+{
+    ariel::Graph g;
+    vector<vector<int>> graph = {
+        {0, 4, 1, 0, 0},
+        {4, 0, 2, 5, 0},
+        {1, 2, 0, 8, 0},
+        {0, 5, 8, 0, 3},
+        {0, 0, 0, 3, 0}};
+    g.loadGraph(graph);
+    ariel::ShortestPathTree tree(g, 0);
+    CHECK(tree.pathTo(4) == "0->2->1->3->4");
+    CHECK(tree.distance(4) == 11);
+
+    SUBCASE("Weight decrease") {
+        tree.setEdge(2, 3, 1);
+        CHECK(tree.pathTo(4) == "0->2->3->4");
+        CHECK(tree.distance(4) == 5);
+    }
+
+    SUBCASE("Tree edge deleted") {
+        tree.setEdge(2, 1, 0);
+        CHECK(tree.pathTo(1) == "0->1");
+        CHECK(tree.distance(3) == 9);
+        tree.setEdge(3, 4, 0);
+        CHECK(tree.pathTo(4) == "-1");
+    }
+
+    SUBCASE("Update that creates a negative cycle is rolled back") {
+        CHECK_THROWS(tree.setEdge(1, 0, -10));
+        CHECK(g.getAdjacencyMatrix()[1][0] == 4);
+        CHECK(tree.distance(4) == 11);
+    }
+
+    SUBCASE("Same distances as a full computation after many updates") {
+        unsigned seed = 11;
+        for (int step = 0; step < 200; ++step) {
+            seed = seed * 1103515245u + 12345u;
+            int u = (seed >> 8) % 5;
+            int v = (seed >> 12) % 5;
+            int w = (seed >> 16) % 10; // 0 deletes the edge
+            if (u == v) continue;
+            tree.setEdge(u, v, w);
+        }
+        ariel::ShortestPathTree fresh(g, 0);
+        bool same = true;
+        for (int v = 0; v < 5; ++v) {
+            same = same && tree.distance(v) == fresh.distance(v);
+        }
+        CHECK(same);
+    }
+}
+
+TEST_CASE("Test graph generator")
+{
+    ariel::Graph g;
+
+    SUBCASE("Same seed gives the same graph") {
+        ariel::Graph other;
+        ariel::GraphGenerator(42, {1, 9}).erdosRenyi(g, 30, 0.2, true);
+        ariel::GraphGenerator(42, {1, 9}).erdosRenyi(other, 30, 0.2, true);
+        CHECK(g.getAdjacencyMatrix() == other.getAdjacencyMatrix());
+        ariel::GraphGenerator(43, {1, 9}).erdosRenyi(other, 30, 0.2, true);
+        CHECK(g.getAdjacencyMatrix() != other.getAdjacencyMatrix());
+    }
+
+    SUBCASE("Grid is connected and has every side edge") {
+        ariel::GraphGenerator(1).grid(g, 4, 5);
+        CHECK(g.getAdjacencyMatrix().size() == 20);
+        CHECK(g.componentCount() == 1);
+        CHECK(ariel::Algorithms::isDirected(g) == false);
+        string path = ariel::Algorithms::shortestPath(g, 0, 19, ariel::ShortestPathEngine::GoldbergRadzik);
+        CHECK(count(path.begin(), path.end(), '>') == 7); // 3 rows down and 4 columns right
+    }
+
+    SUBCASE("Bipartite, DAG and power-law graphs keep their shape") {
+        ariel::GraphGenerator generator(7);
+        generator.bipartite(g, 6, 5, 0.5);
+        CHECK(ariel::Algorithms::isBipartite(g) != "0");
+        generator.dag(g, 12, 0.3);
+        CHECK(ariel::Algorithms::isContainsCycle(g) == false);
+        generator.powerLaw(g, 40, 2);
+        CHECK(g.componentCount() == 1);
+        generator.rmat(g, 5, 4);
+        CHECK(g.getAdjacencyMatrix().size() == 32);
+    }
+
+    SUBCASE("Planted negative cycle is found") {
+        ariel::GraphGenerator(3, {1, 20}).plantedNegativeCycle(g, 25, 0.2, 5);
+        CHECK(ariel::Algorithms::negativeCycle(g) == "The graph cannot be interpreted as undirected.\nNegative cycle detected in the graph.");
+        CHECK_THROWS(ariel::GraphGenerator(3, {-5, 20}).plantedNegativeCycle(g, 25, 0.2, 5));
+    }
+}
+
+TEST_CASE("Test algorithm stats")
+{
+    ariel::StatsRegistry::clear();
+    {
+        ariel::ScopedStats outer("outer");
+        ariel::StatsRegistry::current().edgesScanned += 3;
+        {
+            ariel::ScopedStats inner("inner");
+            ariel::StatsRegistry::current().relaxations += 2;
+        }
+        CHECK(ariel::StatsRegistry::last().relaxations == 2);
+        ariel::StatsRegistry::current().passes += 1;
+    }
+    ariel::AlgorithmStats last = ariel::StatsRegistry::last();
+    CHECK(last.edgesScanned == 3);
+    CHECK(last.relaxations == 2); // the inner call is counted in the outer call too
+    CHECK(last.passes == 1);
+
+    map<string, ariel::AggregateStats> all = ariel::StatsRegistry::aggregate();
+    CHECK(all["outer"].calls == 1);
+    CHECK(all["inner"].total.relaxations == 2);
+    ariel::StatsRegistry::clear();
+    CHECK(ariel::StatsRegistry::aggregate().empty());
+}
+
+TEST_CASE("Test versioned graph snapshots")
+{
+    ariel::Graph g;
+    g.loadEmpty(8);
+    ariel::VersionedGraph shared(g);
+
+    SUBCASE("A pinned snapshot doesn't change") {
+        shared_ptr<const ariel::Graph> before = shared.snapshot();
+        shared.setEdge(0, 1, 5);
+        CHECK(before->getAdjacencyMatrix()[0][1] == 0);
+        CHECK(shared.snapshot()->getAdjacencyMatrix()[0][1] == 5);
+        CHECK(shared.version() == 1);
+    }
+
+    SUBCASE("A failed update publishes nothing") {
+        CHECK_THROWS(shared.setEdge(0, 8, 1));
+        CHECK(shared.version() == 0);
+    }
+
+    SUBCASE("A batch of changes is one copy and one version") {
+        shared_ptr<const ariel::Graph> before = shared.snapshot();
+        vector<ariel::EdgeChange> changes;
+        for (int v = 1; v < 8; ++v) {
+            changes.push_back(ariel::EdgeChange{0, v, v});
+            changes.push_back(ariel::EdgeChange{v, 0, v});
+        }
+        shared.setEdges(changes);
+        CHECK(shared.version() == 1);
+        CHECK(before->edgeCount() == 0);
+        CHECK(shared.snapshot()->edgeCount() == 14);
+        CHECK(shared.snapshot()->getAdjacencyMatrix()[5][0] == 5);
+        // a bad change in the middle throws and none of the batch is published
+        changes = {ariel::EdgeChange{1, 2, 1}, ariel::EdgeChange{1, 9, 1}};
+        CHECK_THROWS_AS(shared.setEdges(changes), std::out_of_range);
+        CHECK(shared.version() == 1);
+        CHECK(shared.snapshot()->getAdjacencyMatrix()[1][2] == 0);
+    }
+
+    SUBCASE("Readers never see half of an update") {
+        // every update writes an undirected edge in both directions, so every published version is symmetric
+        atomic<bool> done(false);
+        atomic<int> broken(0);
+        vector<thread> readers;
+        for (int r = 0; r < 3; ++r) {
+            readers.push_back(thread([&]() {
+                while (!done) {
+                    shared_ptr<const ariel::Graph> snap = shared.snapshot();
+                    if (ariel::Algorithms::isDirected(*snap)) {
+                        ++broken;
+                    }
+                }
+            }));
+        }
+        for (int step = 0; step < 300; ++step) {
+            int u = step % 8;
+            int v = (step * 3 + 1) % 8;
+            int w = step % 5;
+            shared.update([u, v, w](ariel::Graph& next) {
+                next.setEdge(u, v, w);
+                next.setEdge(v, u, w);
+            });
+        }
+        done = true;
+        for (thread& t : readers) {
+            t.join();
+        }
+        CHECK(broken == 0);
+        CHECK(shared.version() == 300);
+    }
+}
+
+TEST_CASE("Test thread pool")
+{
+    ariel::ThreadPool pool(4);
+
+    SUBCASE("parallelFor covers every index once") {
+        vector<int> hits(1000, 0);
+        pool.parallelFor(0, hits.size(), 7, [&](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i) {
+                ++hits[i];
+            }
+        });
+        CHECK(count(hits.begin(), hits.end(), 1) == 1000);
+    }
+
+    SUBCASE("Nested task groups finish") {
+        atomic<int> leaves(0);
+        ariel::TaskGroup outer(pool);
+        for (int i = 0; i < 8; ++i) {
+            outer.run([&]() {
+                ariel::TaskGroup inner(pool);
+                for (int j = 0; j < 8; ++j) {
+                    inner.run([&]() { ++leaves; });
+                }
+                inner.wait();
+            });
+        }
+        outer.wait();
+        CHECK(leaves == 64);
+    }
+
+    SUBCASE("wait returns after the tasks running on other threads") {
+        // nothing is left to take, so wait sleeps until the workers finish
+        atomic<int> finished(0);
+        ariel::TaskGroup group(pool);
+        for (int i = 0; i < 4; ++i) {
+            group.run([&]() {
+                this_thread::sleep_for(chrono::milliseconds(20));
+                ++finished;
+            });
+        }
+        this_thread::sleep_for(chrono::milliseconds(5));
+        group.wait();
+        CHECK(finished == 4);
+        group.wait(); // a second wait on a finished group returns at once
+    }
+
+    SUBCASE("The shared pool is the same on every thread") {
+        ariel::ThreadPool* seen[4];
+        vector<thread> threads;
+        for (int i = 0; i < 4; ++i) {
+            threads.push_back(thread([&seen, i]() { seen[i] = &ariel::ThreadPool::instance(); }));
+        }
+        for (thread& t : threads) {
+            t.join();
+        }
+        for (int i = 0; i < 4; ++i) {
+            CHECK(seen[i] == &ariel::ThreadPool::instance());
+        }
+    }
+
+    SUBCASE("Exception of a task reaches wait") {
+        ariel::TaskGroup group(pool);
+        group.run([]() { throw runtime_error("task failed"); });
+        CHECK_THROWS_WITH(group.wait(), "task failed");
+    }
+
+    SUBCASE("Parallel algorithms give the sequential answers") {
+        ariel::Graph g;
+        ariel::GraphGenerator generator(5, {1, 9});
+        generator.dag(g, 60, 0.2);
+        CHECK(ariel::Algorithms::isConnected(g) == false);
+        generator.plantedNegativeCycle(g, 60, 0.1, 4);
+        CHECK(ariel::Algorithms::negativeCycle(g) == "The graph cannot be interpreted as undirected.\nNegative cycle detected in the graph.");
+        CHECK_THROWS(ariel::ThreadPool::configure(2, false)); // the shared pool is already running
+    }
+}
+
+TEST_CASE("Test batch shortestPaths")
+{
+    ariel::Graph g;
+    vector<vector<int>> graph = {
+        {0, 1, 0, 0, 0},
+        {1, 0, 3, 0, 0},
+        {0, 3, 0, 4, 0},
+        {0, 0, 4, 0, 5},
+        {0, 0, 0, 5, 0}};
+    g.loadGraph(graph);
+
+    SUBCASE("Same answers as one by one, in the order of the queries") {
+        vector<pair<int, int>> queries = {{0, 4}, {4, 0}, {0, 2}, {3, 3}, {0, 4}, {2, 1}};
+        vector<string> answers = ariel::Algorithms::shortestPaths(g, queries);
+        REQUIRE(answers.size() == queries.size());
+        bool same = true;
+        for (size_t q = 0; q < queries.size(); ++q) {
+            same = same && answers[q] == ariel::Algorithms::shortestPath(g, queries[q].first, queries[q].second);
+        }
+        CHECK(same);
+        CHECK(answers[0] == "0->1->2->3->4");
+    }
+
+    SUBCASE("Invalid query or negative cycle fails the batch") {
+        CHECK_THROWS(ariel::Algorithms::shortestPaths(g, {{0, 1}, {0, 5}}));
+        g.setEdge(1, 2, -3);
+        g.setEdge(2, 1, -3);
+        CHECK_THROWS(ariel::Algorithms::shortestPaths(g, {{0, 1}, {3, 4}}));
+    }
+
+    SUBCASE("Large batch on a generated graph") {
+        ariel::GraphGenerator(9, {1, 20}).grid(g, 6, 6);
+        vector<pair<int, int>> queries;
+        for (int q = 0; q < 40; ++q) {
+            queries.push_back({(q * 7) % 36, (q * 11) % 36});
+        }
+        vector<string> answers = ariel::Algorithms::shortestPaths(g, queries, ariel::ShortestPathEngine::GoldbergRadzik);
+        bool same = true;
+        for (size_t q = 0; q < queries.size(); ++q) {
+            same = same && answers[q] == ariel::Algorithms::shortestPath(g, queries[q].first, queries[q].second, ariel::ShortestPathEngine::GoldbergRadzik);
+        }
+        CHECK(same);
+    }
+}
+
+TEST_CASE("Test multi-source BFS")
+{
+    ariel::Graph g;
+
+    SUBCASE("Hop distances from a few sources") {
+        vector<vector<int>> graph = {
+            {0, 1, 0, 0},
+            {0, 0, 5, 0},
+            {0, 0, 0, 1},
+            {0, 0, 0, 0}};
+        g.loadGraph(graph);
+        vector<vector<int>> hops = ariel::Algorithms::hopDistances(g, {0, 2, 3});
+        CHECK(hops[0] == vector<int>({0, 1, 2, 3}));
+        CHECK(hops[1] == vector<int>({-1, -1, 0, 1}));
+        CHECK(hops[2] == vector<int>({-1, -1, -1, 0}));
+        CHECK(ariel::Algorithms::reachesAll(g, {0}) == true);
+        CHECK(ariel::Algorithms::reachesAll(g, {0, 1}) == false);
+        CHECK_THROWS(ariel::Algorithms::hopDistances(g, {4}));
+        CHECK_THROWS_AS(ariel::Algorithms::reachesAll(g, {4}), std::invalid_argument);
+        CHECK_THROWS_AS(ariel::Algorithms::reachesAll(g, {0, -1}), std::invalid_argument);
+        CHECK_THROWS_AS(ariel::Algorithms::reachesAll(ariel::Graph(), {0}), std::invalid_argument);
+    }
+
+    SUBCASE("More than 64 sources match a BFS from each one") {
+        ariel::GraphGenerator(21).rmat(g, 7, 3);
+        int n = g.getAdjacencyMatrix().size();
+        vector<int> sources;
+        for (int s = 0; s < n; ++s) {
+            sources.push_back(s);
+        }
+        vector<vector<int>> hops = ariel::Algorithms::hopDistances(g, sources);
+        bool same = true;
+        for (int s = 0; s < n; s += 9) {
+            vector<int> expected(n, -1);
+            vector<int> q(1, s);
+            expected[s] = 0;
+            for (size_t head = 0; head < q.size(); ++head) {
+                for (int v = 0; v < n; ++v) {
+                    if (g.getAdjacencyMatrix()[q[head]][v] != 0 && expected[v] == -1) {
+                        expected[v] = expected[q[head]] + 1;
+                        q.push_back(v);
+                    }
+                }
+            }
+            same = same && hops[s] == expected;
+        }
+        CHECK(same);
+    }
+
+    SUBCASE("isConnected on a directed cycle of 100 vertices") {
+        g.loadEmpty(100);
+        for (int v = 0; v < 100; ++v) {
+            g.setEdge(v, (v + 1) % 100, 1);
+        }
+        CHECK(ariel::Algorithms::isConnected(g) == true);
+        g.setEdge(99, 0, 0);
+        CHECK(ariel::Algorithms::isConnected(g) == false);
+    }
+}
+
+TEST_CASE("Test vertex reordering")
+{
+    ariel::Graph g;
+    ariel::GraphGenerator(17, {1, 30}).grid(g, 5, 6);
+
+    SUBCASE("Orders are permutations with their inverse") {
+        ariel::Permutation rcm = ariel::VertexOrder::reverseCuthillMcKee(g);
+        ariel::Permutation bigFirst = ariel::VertexOrder::degreeSorted(g);
+        bool inverse = true;
+        for (int v = 0; v < 30; ++v) {
+            inverse = inverse && rcm.newToOld[rcm.oldToNew[v]] == v && bigFirst.newToOld[bigFirst.oldToNew[v]] == v;
+        }
+        CHECK(inverse);
+        CHECK_THROWS(ariel::VertexOrder::fromOrder({0, 0, 1}));
+    }
+
+    SUBCASE("Attributes move with their vertices") {
+        ariel::Permutation p = ariel::VertexOrder::degreeSorted(g);
+        g.setAttribute("id", 7, 7.5);
+        ariel::Graph moved = ariel::VertexOrder::apply(g, p);
+        CHECK(moved.attributeNames() == vector<string>({"id", "x", "y"}));
+        bool same = true;
+        for (int v = 0; v < 30; ++v) {
+            same = same && moved.attribute("x")[p.oldToNew[v]] == g.attribute("x")[v]
+                        && moved.attribute("y")[p.oldToNew[v]] == g.attribute("y")[v];
+        }
+        CHECK(same);
+        CHECK(moved.attribute("id")[p.oldToNew[7]] == 7.5);
+        // the coordinates still fit the edges, so the heuristic search works on the reordered grid
+        int from = p.oldToNew[0];
+        int to = p.oldToNew[29];
+        vector<int> dist;
+        vector<int> parent;
+        ariel::Algorithms::dijkstra(moved, from, dist, parent);
+        CHECK(ariel::Algorithms::aStarSearch(moved, from, to, ariel::Algorithms::coordinateHeuristic(
+                  moved.attribute("x"), moved.attribute("y"), to, ariel::Heuristic::Manhattan)).distance == dist[to]);
+        CHECK(ariel::Algorithms::aStar(moved, from, to, ariel::Heuristic::Manhattan) != "-1");
+    }
+
+    SUBCASE("Reordered graph answers in the original numbers") {
+        ariel::ReorderedGraph reordered(g, ariel::VertexOrder::reverseCuthillMcKee(g));
+        CHECK(reordered.isConnected() == ariel::Algorithms::isConnected(g));
+        CHECK(reordered.sameComponent(0, 29) == true);
+
+        // the path may differ on ties, so compare the path lengths
+        string path = reordered.shortestPath(0, 29);
+        int length = 0;
+        stringstream ss(path);
+        string item;
+        int prev = -1;
+        bool edges = true;
+        while (getline(ss, item, '>')) {
+            int v = atoi(item.c_str());
+            if (prev != -1) {
+                edges = edges && g.getAdjacencyMatrix()[prev][v] != 0;
+                length += g.getAdjacencyMatrix()[prev][v];
+            }
+            prev = v;
+        }
+        vector<int> dist(30, numeric_limits<int>::max());
+        dist[0] = 0;
+        ariel::Algorithms::bellmanFord(g, dist);
+        CHECK(edges);
+        CHECK(prev == 29);
+        CHECK(length == dist[29]);
+
+        vector<vector<int>> hops = reordered.hopDistances({0, 7});
+        CHECK(hops == ariel::Algorithms::hopDistances(g, {0, 7}));
+    }
+
+    SUBCASE("Reordered isBipartite and negativeCycle answer in the original numbers") {
+        // a path 0-1-2-3 and the isolated vertices 4 and 5
+        ariel::Graph path;
+        path.loadEmpty(6);
+        for (int v = 0; v < 3; ++v) {
+            path.setEdge(v, v + 1, 1);
+            path.setEdge(v + 1, v, 1);
+        }
+        ariel::ReorderedGraph reversed(path, ariel::VertexOrder::fromOrder({5, 4, 3, 2, 1, 0}));
+        CHECK(reversed.isBipartite() == ariel::Algorithms::isBipartite(path));
+        CHECK(reversed.isBipartite() == "The graph is bipartite: A={0, 2, 4}, B={1, 3, 5}");
+        ariel::ReorderedGraph sorted(path, ariel::VertexOrder::degreeSorted(path));
+        CHECK(sorted.isBipartite() == ariel::Algorithms::isBipartite(path));
+        path.setEdge(0, 2, 1);
+        path.setEdge(2, 0, 1);
+        CHECK(ariel::ReorderedGraph(path, ariel::VertexOrder::degreeSorted(path)).isBipartite() == "0");
+
+        // the undirected check runs from vertex 2, which is in the component with the negative triangle
+        ariel::Graph split;
+        split.loadEmpty(6);
+        split.setEdge(0, 1, 4);
+        split.setEdge(1, 0, 4);
+        for (int v = 2; v < 5; ++v) {
+            int w = v == 4 ? 2 : v + 1;
+            split.setEdge(v, w, -1);
+            split.setEdge(w, v, -1);
+        }
+        ariel::ReorderedGraph moved(split, ariel::VertexOrder::fromOrder({2, 3, 0, 1, 4, 5}));
+        CHECK(moved.negativeCycle() == ariel::Algorithms::negativeCycle(split));
+        CHECK(moved.negativeCycle() == "Negative cycle detected in undirected graph.\nNegative cycle detected in directed graph.");
+        CHECK(moved.negativeCycle() != ariel::Algorithms::negativeCycle(moved.getGraph()));
+    }
+}
+
+TEST_CASE("Test workspace")
+{
+    SUBCASE("A new frame gets the buffer of the last one")
+    {
+        const int* first;
+        {
+            ariel::Workspace ws;
+            vector<int>& a = ws.take<int>(100, 7);
+            CHECK(a.size() == 100);
+            CHECK(a[99] == 7);
+            first = a.data();
+        }
+        {
+            ariel::Workspace ws;
+            vector<int>& b = ws.take<int>(50, -1);
+            CHECK(b.size() == 50);
+            CHECK(b[0] == -1);
+            CHECK(b.data() == first);
+        }
+    }
+
+    SUBCASE("Nested frames don't share buffers")
+    {
+        ariel::Workspace outer;
+        vector<int>& a = outer.take<int>(10, 1);
+        vector<bool>& seen = outer.take<bool>(10, false);
+        {
+            ariel::Workspace inner;
+            vector<int>& b = inner.take<int>(10, 2);
+            CHECK(&a != &b);
+            b[0] = 5;
+        }
+        CHECK(a[0] == 1);
+        CHECK(seen[3] == false);
+        ariel::Workspace again;
+        CHECK(&again.take<int>(0, 0) != &a);
+    }
+
+    SUBCASE("Algorithms give their buffers back")
+    {
+        ariel::Graph g;
+        ariel::GraphGenerator gen(5, ariel::WeightRange{1, 9});
+        gen.grid(g, 4, 4);
+        string first = ariel::Algorithms::shortestPath(g, 0, 15);
+        for (int i = 0; i < 10; i++) {
+            CHECK(ariel::Algorithms::shortestPath(g, 0, 15) == first);
+        }
+        CHECK(ariel::ScratchPool<int>::local().top == 0);
+        CHECK(ariel::ScratchPool<bool>::local().top == 0);
+    }
+}
+
+TEST_CASE("Test visited set")
+{
+    SUBCASE("Marks and clear")
+    {
+        ariel::VisitedSet visited(5);
+        CHECK(visited.size() == 5);
+        CHECK(visited.visit(2) == true);
+        CHECK(visited.visit(2) == false);
+        CHECK(visited.contains(2) == true);
+        visited.mark(4);
+        visited.unmark(2);
+        CHECK(visited.contains(2) == false);
+        CHECK(visited.contains(4) == true);
+        visited.clear();
+        for (size_t v = 0; v < 5; v++) {
+            CHECK(visited.contains(v) == false);
+        }
+        visited.prepare(7);
+        CHECK(visited.size() == 7);
+        CHECK(visited.contains(6) == false);
+    }
+
+    SUBCASE("Many clears don't bring old marks back")
+    {
+        ariel::VisitedSet visited(3);
+        for (int i = 0; i < 1000; i++) {
+            visited.mark(i % 3);
+            visited.clear();
+        }
+        CHECK(visited.contains(0) == false);
+        CHECK(visited.contains(1) == false);
+        CHECK(visited.contains(2) == false);
+    }
+
+    SUBCASE("dfs marks the reachable vertices")
+    {
+        ariel::Graph g;
+        vector<vector<int>> graph = {
+            {0, 1, 0, 0},
+            {0, 0, 1, 0},
+            {0, 0, 0, 0},
+            {1, 0, 0, 0}};
+        g.loadGraph(graph);
+        ariel::VisitedSet visited(4);
+        ariel::Algorithms::dfs(g, 0, visited, 4);
+        CHECK(visited.contains(2) == true);
+        CHECK(visited.contains(3) == false);
+        visited.clear();
+        ariel::Algorithms::dfs(g, 3, visited, 4);
+        CHECK(visited.contains(1) == true);
+    }
+
+    SUBCASE("The vector<bool> signatures give the same marks")
+    {
+        ariel::Graph g;
+        vector<vector<int>> graph = {
+            {0, 1, 0, 0, 0},
+            {1, 0, 1, 0, 0},
+            {0, 1, 0, 1, 0},
+            {0, 0, 1, 0, 0},
+            {0, 0, 0, 0, 0}};
+        g.loadGraph(graph);
+        vector<bool> visited(5, false);
+        visited[4] = true;
+        ariel::Algorithms::dfs(g, 1, visited, 5);
+        CHECK(visited == vector<bool>({true, true, true, true, true}));
+
+        vector<bool> seen(5, false);
+        vector<int> parent(5, -1);
+        CHECK(ariel::Algorithms::dfsCycleCheck(g, 0, seen, parent) == false);
+        // the cycle check unmarks every vertex on its way back
+        CHECK(seen == vector<bool>(5, false));
+        CHECK(parent == vector<int>({-1, 0, 1, 2, -1}));
+        graph[0][2] = 1;
+        graph[2][0] = 1;
+        g.loadGraph(graph);
+        vector<bool> again(5, false);
+        parent.assign(5, -1);
+        CHECK(ariel::Algorithms::dfsCycleCheck(g, 0, again, parent) == true);
+    }
+
+    SUBCASE("Repeated cycle checks reuse the set")
+    {
+        ariel::Graph g;
+        ariel::GraphGenerator gen(11);
+        gen.dag(g, 20, 0.3);
+        for (int i = 0; i < 5; i++) {
+            CHECK(ariel::Algorithms::isContainsCycle(g) == false);
+        }
+        vector<vector<int>> graph = g.getAdjacencyMatrix();
+        graph[0][1] = 1;
+        graph[1][2] = 1;
+        graph[2][0] = 1;
+        g.loadGraph(graph);
+        CHECK(ariel::Algorithms::isContainsCycle(g) == true);
+    }
+}
+
+TEST_CASE("Test epoch array")
+{
+    SUBCASE("prepare resets every entry")
+    {
+        ariel::EpochArray<int> dist;
+        dist.prepare(6, 100);
+        CHECK(dist.size() == 6);
+        dist.set(2, 7);
+        dist.set(5, -3);
+        CHECK(dist[2] == 7);
+        CHECK(dist[5] == -3);
+        CHECK(dist[0] == 100);
+        dist.prepare(6, -1);
+        for (size_t v = 0; v < 6; v++) {
+            CHECK(dist[v] == -1);
+        }
+        dist.set(2, 4);
+        dist.prepare(9, 0);
+        CHECK(dist.size() == 9);
+        CHECK(dist[2] == 0);
+        CHECK(dist[8] == 0);
+    }
+
+    SUBCASE("A* gives the same answer when its arrays are reused")
+    {
+        ariel::Graph g;
+        ariel::GraphGenerator gen(5, {1, 9});
+        gen.grid(g, 8, 8);
+        auto none = [](int) { return 0.0; };
+        vector<int> dist;
+        vector<int> parent;
+        for (int end : {63, 9, 63, 0, 40}) {
+            ariel::PathResult result = ariel::Algorithms::aStarSearch(g, 0, end, none);
+            ariel::Algorithms::dijkstra(g, 0, dist, parent);
+            CHECK(result.distance == dist[end]);
+            CHECK(result.path.front() == 0);
+            CHECK(result.path.back() == end);
+        }
+    }
+}
+
+TEST_CASE("Test SIMD kernels")
+{
+    vector<ariel::SimdLevel> levels = {ariel::SimdLevel::Scalar, ariel::SimdLevel::SSE41,
+                                       ariel::SimdLevel::AVX2, ariel::SimdLevel::AVX512};
+    ariel::SimdLevel original = ariel::SimdKernels::level();
+    const int INF = numeric_limits<int>::max();
+
+    SUBCASE("Every level relaxes a row like the scalar loop")
+    {
+        // 37 entries so every level also runs its scalar tail
+        vector<int> row(37);
+        vector<int> startDist(37);
+        for (int v = 0; v < 37; v++) {
+            row[v] = (v % 3 == 0) ? 0 : (v * 7) % 11 - 4;
+            startDist[v] = (v % 4 == 0) ? INF : (v * 5) % 13;
+        }
+        row[20] = INF;      // saturates to INF and never relaxes
+        row[21] = -INF;     // saturates at the bottom instead of wrapping
+        size_t edges = 37 - count(row.begin(), row.end(), 0);
+        for (int skip : {-1, 5}) {
+            vector<int> expectDist = startDist;
+            vector<int> expectParent(37, -1);
+            size_t expectRelaxed = 0;
+            for (int v = 0; v < 37; v++) {
+                long long candidate = 3LL + row[v];
+                candidate = max<long long>(min<long long>(candidate, INF), numeric_limits<int>::min());
+                if (row[v] != 0 && v != skip && expectDist[v] > candidate) {
+                    expectDist[v] = (int)candidate;
+                    expectParent[v] = 9;
+                    expectRelaxed++;
+                }
+            }
+            for (ariel::SimdLevel level : levels) {
+                ariel::SimdKernels::setLevel(level);
+                vector<int> dist = startDist;
+                vector<int> parent(37, -1);
+                size_t relaxed = ariel::SimdKernels::relaxRow(row.data(), 3, 9, skip, dist.data(), parent.data(), 37);
+                CHECK(relaxed == expectRelaxed);
+                CHECK(dist == expectDist);
+                CHECK(parent == expectParent);
+                CHECK(ariel::SimdKernels::countNonZero(row.data(), 37) == edges);
+            }
+        }
+    }
+
+    SUBCASE("Sparse rows saturate like the kernel")
+    {
+        // 20 vertices and one edge per row, so relax walks every row edge by edge
+        ariel::Graph g;
+        g.loadEmpty(20);
+        g.setEdge(0, 1, INF - 2);
+        g.setEdge(2, 3, numeric_limits<int>::min() + 2);
+        g.setEdge(4, 5, 7);
+        vector<int> dist(20, INF);
+        vector<int> parent(20, -1);
+        dist[0] = 5;
+        dist[2] = -5;
+        dist[4] = 1;
+        ariel::Algorithms::relax(g, dist, parent, true);
+        CHECK(dist[1] == INF); // 5 + INF - 2 stays at INF instead of wrapping to a negative distance
+        CHECK(parent[1] == -1);
+        CHECK(dist[3] == numeric_limits<int>::min());
+        CHECK(parent[3] == 2);
+        CHECK(dist[5] == 8);
+    }
+
+    SUBCASE("setLevel never goes above the CPU")
+    {
+        ariel::SimdLevel best = ariel::SimdKernels::detect();
+        CHECK(ariel::SimdKernels::setLevel(ariel::SimdLevel::AVX512) == best);
+        CHECK(ariel::SimdKernels::setLevel(ariel::SimdLevel::Scalar) == ariel::SimdLevel::Scalar);
+        CHECK(string(ariel::SimdKernels::levelName(ariel::SimdLevel::AVX2)) == "avx2");
+    }
+
+    SUBCASE("Shortest paths are the same at every level")
+    {
+        ariel::Graph directed;
+        ariel::Graph undirected;
+        ariel::GraphGenerator gen(21, ariel::WeightRange{-2, 9});
+        gen.dag(directed, 40, 0.2);
+        ariel::GraphGenerator positive(22, ariel::WeightRange{1, 9});
+        positive.erdosRenyi(undirected, 40, 0.15, false);
+        vector<vector<int>> expected;
+        for (ariel::SimdLevel level : levels) {
+            ariel::SimdKernels::setLevel(level);
+            vector<vector<int>> results;
+            for (ariel::Graph* g : {&directed, &undirected}) {
+                vector<int> dist(40, INF);
+                dist[0] = 0;
+                CHECK(ariel::Algorithms::bellmanFord(*g, dist) == false);
+                results.push_back(dist);
+            }
+            if (expected.empty()) {
+                expected = results;
+            }
+            CHECK(results == expected);
+        }
+    }
+
+    ariel::SimdKernels::setLevel(original);
+}
+
+TEST_CASE("Test blocked isDirected")
+{
+    ariel::SimdLevel original = ariel::SimdKernels::level();
+    vector<ariel::SimdLevel> levels = {ariel::SimdLevel::Scalar, ariel::SimdLevel::SSE41,
+                                       ariel::SimdLevel::AVX2, ariel::SimdLevel::AVX512};
+
+    SUBCASE("Every asymmetric cell is found at every level")
+    {
+        // 150 vertices: several tiles, and blocks that don't divide the tile size
+        const int n = 150;
+        ariel::Graph g;
+        ariel::GraphGenerator gen(31, ariel::WeightRange{1, 9});
+        gen.erdosRenyi(g, n, 0.3, false);
+        vector<vector<int>> symmetric = g.getAdjacencyMatrix();
+        for (ariel::SimdLevel level : levels) {
+            ariel::SimdKernels::setLevel(level);
+            CHECK(ariel::Algorithms::isDirected(g) == false);
+        }
+        for (int cell : {0, 7, 63, 64, 71, 149}) {
+            vector<vector<int>> graph = symmetric;
+            int i = cell % n;
+            int j = (cell * 37 + 5) % n;
+            if (i == j) {
+                j = (j + 1) % n;
+            }
+            graph[i][j] = graph[j][i] + 3;
+            g.loadGraph(graph);
+            for (ariel::SimdLevel level : levels) {
+                ariel::SimdKernels::setLevel(level);
+                CHECK(ariel::Algorithms::isDirected(g) == true);
+            }
+        }
+    }
+
+    SUBCASE("Tiles smaller than a vector block")
+    {
+        ariel::Graph g;
+        vector<vector<int>> graph = {
+            {0, 1, 2},
+            {1, 0, 3},
+            {2, 3, 0}};
+        g.loadGraph(graph);
+        for (ariel::SimdLevel level : levels) {
+            ariel::SimdKernels::setLevel(level);
+            CHECK(ariel::Algorithms::isDirected(g) == false);
+        }
+        graph[2][1] = -3;
+        g.loadGraph(graph);
+        for (ariel::SimdLevel level : levels) {
+            ariel::SimdKernels::setLevel(level);
+            CHECK(ariel::Algorithms::isDirected(g) == true);
+        }
+    }
+
+    ariel::SimdKernels::setLevel(original);
+}
+
+TEST_CASE("Test graph statistics")
+{
+    ariel::SimdLevel original = ariel::SimdKernels::level();
+    vector<ariel::SimdLevel> levels = {ariel::SimdLevel::Scalar, ariel::SimdLevel::SSE41,
+                                       ariel::SimdLevel::AVX2, ariel::SimdLevel::AVX512};
+
+    SUBCASE("Small graph")
+    {
+        ariel::Graph g;
+        vector<vector<int>> graph = {
+            {2, 1, 0},
+            {0, 0, -4},
+            {7, 0, 0}};
+        g.loadGraph(graph);
+        ariel::GraphStats stats = ariel::Algorithms::graphStats(g);
+        CHECK(stats.vertices == 3);
+        CHECK(stats.edges == 4);
+        CHECK(stats.negativeEdges == 1);
+        CHECK(stats.selfLoops == 1);
+        CHECK(stats.minWeight == -4);
+        CHECK(stats.maxWeight == 7);
+        CHECK(stats.outDegree == vector<size_t>({2, 1, 1}));
+        CHECK(stats.inDegree == vector<size_t>({2, 1, 1}));
+        vector<int> dist;
+        CHECK(ariel::Algorithms::hasNegativeEdge(g, dist) == true);
+    }
+
+    SUBCASE("A graph without edges")
+    {
+        ariel::Graph g;
+        g.loadEmpty(5);
+        ariel::GraphStats stats = ariel::Algorithms::graphStats(g, true);
+        CHECK(stats.edges == 0);
+        CHECK(stats.minWeight == 0);
+        CHECK(stats.maxWeight == 0);
+        CHECK(stats.inDegree == vector<size_t>(5, 0));
+    }
+
+    SUBCASE("Every level and the parallel scan agree with a plain count")
+    {
+        const int n = 75;
+        ariel::Graph g;
+        ariel::GraphGenerator gen(41, ariel::WeightRange{-5, 12});
+        gen.erdosRenyi(g, n, 0.4, true);
+        vector<vector<int>> graph = g.getAdjacencyMatrix();
+        graph[10][10] = 3;
+        graph[74][74] = -1;
+        g.loadGraph(graph);
+
+        size_t edges = 0;
+        size_t negative = 0;
+        int low = numeric_limits<int>::max();
+        int high = numeric_limits<int>::min();
+        vector<size_t> in(n, 0);
+        vector<size_t> out(n, 0);
+        for (int u = 0; u < n; u++) {
+            for (int v = 0; v < n; v++) {
+                if (graph[u][v] != 0) {
+                    edges++;
+                    negative += graph[u][v] < 0;
+                    low = min(low, graph[u][v]);
+                    high = max(high, graph[u][v]);
+                    out[u]++;
+                    in[v]++;
+                }
+            }
+        }
+        for (ariel::SimdLevel level : levels) {
+            ariel::SimdKernels::setLevel(level);
+            for (bool parallel : {false, true}) {
+                ariel::GraphStats stats = ariel::Algorithms::graphStats(g, parallel);
+                CHECK(stats.edges == edges);
+                CHECK(stats.negativeEdges == negative);
+                CHECK(stats.selfLoops == 2);
+                CHECK(stats.minWeight == low);
+                CHECK(stats.maxWeight == high);
+                CHECK(stats.inDegree == in);
+                CHECK(stats.outDegree == out);
+            }
+            vector<int> dist;
+            CHECK(ariel::Algorithms::hasNegativeEdge(g, dist) == (negative > 0));
+        }
+
+        // only one negative weight, at the end of the last row
+        for (int u = 0; u < n; u++) {
+            for (int v = 0; v < n; v++) {
+                graph[u][v] = abs(graph[u][v]);
+            }
+        }
+        g.loadGraph(graph);
+        for (ariel::SimdLevel level : levels) {
+            ariel::SimdKernels::setLevel(level);
+            vector<int> dist;
+            CHECK(ariel::Algorithms::hasNegativeEdge(g, dist) == false);
+        }
+        graph[74][73] = -2;
+        g.loadGraph(graph);
+        for (ariel::SimdLevel level : levels) {
+            ariel::SimdKernels::setLevel(level);
+            vector<int> dist;
+            CHECK(ariel::Algorithms::hasNegativeEdge(g, dist) == true);
+        }
+    }
+
+    ariel::SimdKernels::setLevel(original);
+}
+
+TEST_CASE("Test cached graph metadata")
+{
+    // recounts everything from the matrix, to compare with what the graph kept
+    auto checkMetadata = [](const ariel::Graph& g) {
+        const vector<vector<int>>& m = g.getAdjacencyMatrix();
+        size_t n = m.size();
+        bool directed = false;
+        size_t edges = 0, negative = 0, loops = 0;
+        bool unit = true;
+        for (size_t i = 0; i < n; i++) {
+            size_t out = 0, in = 0;
+            for (size_t j = 0; j < n; j++) {
+                directed = directed || m[i][j] != m[j][i];
+                if (m[i][j] != 0) {
+                    edges++;
+                    out++;
+                    negative += m[i][j] < 0;
+                    loops += i == j;
+                    unit = unit && m[i][j] == 1;
+                }
+                in += m[j][i] != 0;
+            }
+            CHECK(g.outDegree(i) == out);
+            CHECK(g.inDegree(i) == in);
+        }
+        CHECK(g.isDirected() == directed);
+        CHECK(g.edgeCount() == edges);
+        CHECK(g.negativeEdgeCount() == negative);
+        CHECK(g.selfLoopCount() == loops);
+        CHECK(g.hasUnitWeights() == unit);
+    };
+
+    SUBCASE("loadGraph")
+    {
+        ariel::Graph g;
+        vector<vector<int>> graph = {
+            {1, 1, 0},
+            {1, 0, -2},
+            {0, 3, 0}};
+        g.loadGraph(graph);
+        checkMetadata(g);
+        CHECK(g.isDirected() == true);
+        CHECK(g.edgeCount() == 5);
+        CHECK(g.selfLoopCount() == 1);
+        CHECK(g.hasUnitWeights() == false);
+        CHECK_THROWS(g.outDegree(3));
+        CHECK_THROWS(g.inDegree(-1));
+
+        ariel::GraphGenerator gen(51, ariel::WeightRange{-3, 3});
+        gen.erdosRenyi(g, 140, 0.2, false);
+        checkMetadata(g);
+        CHECK(g.isDirected() == false);
+        gen.erdosRenyi(g, 140, 0.2, true);
+        checkMetadata(g);
+    }
+
+    SUBCASE("setEdge, addNode and removeNode keep it updated")
+    {
+        ariel::Graph g;
+        g.loadEmpty(6);
+        checkMetadata(g);
+        CHECK(g.hasUnitWeights() == true);
+        g.setEdge(0, 1, 1);
+        checkMetadata(g);
+        CHECK(g.isDirected() == true);
+        g.setEdge(1, 0, 1);
+        checkMetadata(g);
+        CHECK(g.isDirected() == false);
+        CHECK(g.hasUnitWeights() == true);
+        g.setEdge(2, 2, -4);
+        g.setEdge(3, 5, 7);
+        checkMetadata(g);
+        g.setEdge(3, 5, 0);
+        g.setEdge(2, 2, 2);
+        checkMetadata(g);
+        g.addNode();
+        g.setEdge(6, 0, -1);
+        g.setEdge(6, 6, 5);
+        g.setEdge(4, 6, 2);
+        checkMetadata(g);
+        g.removeNode();
+        checkMetadata(g);
+        CHECK(g.negativeEdgeCount() == 0);
+        g.removeNode();
+        checkMetadata(g);
+    }
+
+    SUBCASE("The algorithms answer from the metadata")
+    {
+        ariel::Graph g;
+        vector<vector<int>> graph = {
+            {0, 1, 0},
+            {0, 0, 2},
+            {4, 0, 0}};
+        g.loadGraph(graph);
+        vector<int> dist;
+        CHECK(ariel::Algorithms::hasNegativeEdge(g, dist) == false);
+        CHECK(ariel::Algorithms::negativeCycle(g) == "The graph cannot be interpreted as undirected.\nNo negative cycle detected in the graph.");
+        g.setEdge(2, 0, -4);
+        CHECK(ariel::Algorithms::hasNegativeEdge(g, dist) == true);
+        CHECK(ariel::Algorithms::negativeCycle(g) == "The graph cannot be interpreted as undirected.\nNegative cycle detected in the graph.");
+        CHECK_THROWS(ariel::Algorithms::shortestPath(g, 0, 2));
+        g.setEdge(2, 0, 0);
+        CHECK(ariel::Algorithms::shortestPath(g, 0, 2) == "0->1->2");
+    }
+}
+
+TEST_CASE("Test neighbor ranges")
+{
+    // the neighbors must be the non zero cells of the row, in order
+    auto checkNeighbors = [](const ariel::Graph& g) {
+        const vector<vector<int>>& m = g.getAdjacencyMatrix();
+        for (size_t u = 0; u < m.size(); u++) {
+            vector<pair<int, int>> expected;
+            for (size_t v = 0; v < m.size(); v++) {
+                if (m[u][v] != 0) {
+                    expected.push_back(make_pair((int)v, m[u][v]));
+                }
+            }
+            vector<pair<int, int>> actual;
+            for (const ariel::Neighbor& e : g.neighbors(u)) {
+                actual.push_back(make_pair(e.vertex, e.weight));
+            }
+            CHECK(actual == expected);
+            CHECK(g.neighbors(u).size() == g.outDegree(u));
+        }
+    };
+
+    SUBCASE("loadGraph and setEdge")
+    {
+        ariel::Graph g;
+        vector<vector<int>> graph = {
+            {0, 4, 0, 2},
+            {0, 0, 0, 0},
+            {1, 0, 3, 0},
+            {0, -1, 0, 0}};
+        g.loadGraph(graph);
+        checkNeighbors(g);
+        CHECK(g.neighbors(1).empty());
+        CHECK(g.neighbors(0)[1].vertex == 3);
+        CHECK(g.neighbors(0)[1].weight == 2);
+        CHECK_THROWS(g.neighbors(4));
+
+        g.setEdge(0, 2, 7);   // inserted in the middle
+        g.setEdge(0, 3, 5);   // updated in place
+        g.setEdge(2, 0, 0);   // erased
+        g.setEdge(1, 1, 6);
+        checkNeighbors(g);
+    }
+
+    SUBCASE("addNode and removeNode")
+    {
+        ariel::Graph g;
+        g.loadEmpty(3);
+        g.setEdge(0, 1, 1);
+        g.addNode();
+        g.setEdge(0, 3, 2);
+        g.setEdge(2, 3, 3);
+        g.setEdge(3, 1, 4);
+        checkNeighbors(g);
+        g.removeNode();
+        checkNeighbors(g);
+        CHECK(g.neighbors(0).size() == 1);
+        CHECK(g.neighbors(2).empty());
+    }
+
+    SUBCASE("Random updates on a sparse graph")
+    {
+        ariel::Graph g;
+        ariel::GraphGenerator gen(61, ariel::WeightRange{-3, 5});
+        gen.erdosRenyi(g, 60, 0.05, true);
+        checkNeighbors(g);
+        for (int k = 0; k < 300; k++) {
+            int u = (k * 17) % 60;
+            int v = (k * 29 + 3) % 60;
+            g.setEdge(u, v, k % 4 == 0 ? 0 : k % 7 - 3);
+        }
+        checkNeighbors(g);
+    }
+
+    SUBCASE("Sparse and dense rows give the same shortest paths")
+    {
+        // a long path with a few chords: every row is sparse, so relax walks the lists
+        ariel::Graph g;
+        g.loadEmpty(50);
+        for (int v = 0; v + 1 < 50; v++) {
+            g.setEdge(v, v + 1, 2);
+        }
+        g.setEdge(0, 25, 10);
+        g.setEdge(25, 49, 3);
+        CHECK(ariel::Algorithms::shortestPath(g, 0, 49) == "0->25->49");
+        CHECK(ariel::Algorithms::shortestPath(g, 0, 49, ariel::ShortestPathEngine::GoldbergRadzik) == "0->25->49");
+        CHECK(ariel::Algorithms::isContainsCycle(g) == false);
+        CHECK(ariel::Algorithms::isConnected(g) == false);
+        g.setEdge(49, 0, 1);
+        CHECK(ariel::Algorithms::isConnected(g) == true);
+    }
+}
+
+TEST_CASE("Test transpose index")
+{
+    // the in-edges must be the non zero cells of the column, in order
+    auto checkInNeighbors = [](const ariel::Graph& g) {
+        const vector<vector<int>>& m = g.getAdjacencyMatrix();
+        for (size_t v = 0; v < m.size(); v++) {
+            vector<pair<int, int>> expected;
+            for (size_t u = 0; u < m.size(); u++) {
+                if (m[u][v] != 0) {
+                    expected.push_back(make_pair((int)u, m[u][v]));
+                }
+            }
+            vector<pair<int, int>> actual;
+            for (const ariel::Neighbor& e : g.inNeighbors(v)) {
+                actual.push_back(make_pair(e.vertex, e.weight));
+            }
+            CHECK(actual == expected);
+            CHECK(g.inNeighbors(v).size() == g.inDegree(v));
+        }
+    };
+
+    SUBCASE("Built lazily and kept up to date by the changes")
+    {
+        ariel::Graph g;
+        vector<vector<int>> graph = {
+            {0, 4, 0, 2},
+            {0, 0, 0, 0},
+            {1, 5, 3, 0},
+            {0, -1, 0, 0}};
+        g.loadGraph(graph);
+        checkInNeighbors(g);
+        CHECK(g.inNeighbors(1).size() == 3);
+        CHECK(g.inNeighbors(1)[2].vertex == 3);
+        CHECK(g.inNeighbors(1)[2].weight == -1);
+        CHECK_THROWS(g.inNeighbors(4));
+
+        // a change updates the in-edges of its target only, the other lists stay where they are
+        const ariel::Neighbor* column3 = g.inNeighbors(3).begin();
+        g.setEdge(1, 0, 9);
+        checkInNeighbors(g);
+        CHECK(g.inNeighbors(3).begin() == column3);
+        g.setEdge(2, 1, 0);
+        g.setEdge(2, 1, 7);
+        checkInNeighbors(g);
+        g.addNode();
+        g.setEdge(4, 0, 6);
+        g.setEdge(4, 4, 2);
+        g.setEdge(1, 4, 3);
+        checkInNeighbors(g);
+        CHECK(g.inNeighbors(3).begin() == column3);
+        g.removeNode();
+        checkInNeighbors(g);
+        CHECK(g.inNeighbors(3).begin() == column3);
+
+        // a copy shares the index, so the one that changes drops it and the other keeps it
+        ariel::Graph copy = g;
+        copy.setEdge(0, 1, 0);
+        copy.setEdge(3, 0, 8);
+        checkInNeighbors(copy);
+        checkInNeighbors(g);
+        CHECK(g.inNeighbors(3).begin() == column3);
+        g.setEdge(0, 3, 5);
+        checkInNeighbors(g);
+        checkInNeighbors(copy);
+    }
+
+    SUBCASE("Threads build it on a shared graph")
+    {
+        ariel::Graph g;
+        ariel::GraphGenerator gen(71, ariel::WeightRange{1, 5});
+        gen.erdosRenyi(g, 80, 0.1, true);
+        const ariel::Graph& shared = g;
+        atomic<int> mismatches(0);
+        vector<thread> readers;
+        for (int t = 0; t < 4; t++) {
+            readers.push_back(thread([&shared, &mismatches]() {
+                for (int v = 0; v < 80; v++) {
+                    size_t count = 0;
+                    for (const ariel::Neighbor& e : shared.inNeighbors(v)) {
+                        if (shared.getAdjacencyMatrix()[e.vertex][v] != e.weight) {
+                            mismatches++;
+                        }
+                        count++;
+                    }
+                    if (count != shared.inDegree(v)) {
+                        mismatches++;
+                    }
+                }
+            }));
+        }
+        for (thread& reader : readers) {
+            reader.join();
+        }
+        CHECK(mismatches == 0);
+    }
+
+    SUBCASE("Directed isConnected searches forward and backward")
+    {
+        ariel::Graph g;
+        g.loadEmpty(40);
+        for (int v = 0; v + 1 < 40; v++) {
+            g.setEdge(v, v + 1, 1);
+        }
+        // 0 reaches everyone, but nobody reaches 0
+        CHECK(ariel::Algorithms::isConnected(g) == false);
+        g.setEdge(39, 20, 1);
+        CHECK(ariel::Algorithms::isConnected(g) == false);
+        g.setEdge(20, 0, 1);
+        CHECK(ariel::Algorithms::isConnected(g) == true);
+        vector<int> all(40);
+        for (int v = 0; v < 40; v++) {
+            all[v] = v;
+        }
+        CHECK(ariel::Algorithms::reachesAll(g, all) == true);
+        g.setEdge(19, 20, 0);
+        CHECK(ariel::Algorithms::isConnected(g) == ariel::Algorithms::reachesAll(g, all));
+    }
+}
+
+TEST_CASE("Test adding and removing nodes")
+{
+    // the matrix must stay square, and the counters, lists and transpose must match it
+    auto checkMetadata = [](const ariel::Graph& g) {
+        const vector<vector<int>>& m = g.getAdjacencyMatrix();
+        size_t edges = 0;
+        for (size_t u = 0; u < m.size(); u++) {
+            REQUIRE(m[u].size() == m.size());
+            vector<pair<int, int>> out;
+            vector<pair<int, int>> in;
+            for (size_t v = 0; v < m.size(); v++) {
+                if (m[u][v] != 0) {
+                    out.push_back(make_pair((int)v, m[u][v]));
+                }
+                if (m[v][u] != 0) {
+                    in.push_back(make_pair((int)v, m[v][u]));
+                }
+            }
+            edges += out.size();
+            vector<pair<int, int>> listed;
+            for (const ariel::Neighbor& e : g.neighbors(u)) {
+                listed.push_back(make_pair(e.vertex, e.weight));
+            }
+            vector<pair<int, int>> listedIn;
+            for (const ariel::Neighbor& e : g.inNeighbors(u)) {
+                listedIn.push_back(make_pair(e.vertex, e.weight));
+            }
+            CHECK(listed == out);
+            CHECK(listedIn == in);
+            CHECK(g.outDegree(u) == out.size());
+            CHECK(g.inDegree(u) == in.size());
+        }
+        CHECK(g.edgeCount() == edges);
+    };
+
+    SUBCASE("An edge to a removed node doesn't come back with the next one")
+    {
+        ariel::Graph g;
+        g.loadEmpty(2);
+        g.addNode();
+        g.addNode();
+        g.setEdge(2, 3, 1);
+        g.removeNode();
+        g.addNode();
+        CHECK(g.getAdjacencyMatrix()[2][3] == 0);
+        checkMetadata(g);
+        g.setEdge(2, 3, 0);
+        g.setEdge(3, 2, 4);
+        checkMetadata(g);
+    }
+
+    SUBCASE("Random additions, removals and edges")
+    {
+        ariel::Graph g;
+        g.loadEmpty(3);
+        mt19937 random(7);
+        for (int step = 0; step < 400; step++) {
+            int action = random() % 4;
+            size_t n = g.getAdjacencyMatrix().size();
+            if (action == 0) {
+                g.addNode();
+            } else if (action == 1 && n > 1) {
+                g.removeNode();
+            } else if (n > 0) {
+                g.setEdge(random() % n, random() % n, (int)(random() % 5) - 1);
+            }
+            if (step % 20 == 0) {
+                checkMetadata(g);
+            }
+        }
+        checkMetadata(g);
+    }
+}
+
+TEST_CASE("Test Dijkstra and delta-stepping")
+{
+    const int INF = numeric_limits<int>::max();
+    // Bellman-Ford distances, to compare with
+    auto reference = [INF](const ariel::Graph& g, int start) {
+        vector<int> dist(g.getAdjacencyMatrix().size(), INF);
+        dist[start] = 0;
+        ariel::Algorithms::bellmanFord(g, dist);
+        return dist;
+    };
+    // every parent must be a real edge on a shortest path
+    auto checkTree = [INF](const ariel::Graph& g, int start, const vector<int>& dist, const vector<int>& parent) {
+        for (size_t v = 0; v < dist.size(); v++) {
+            if ((int)v == start || dist[v] == INF) {
+                CHECK(parent[v] == -1);
+            } else {
+                int p = parent[v];
+                REQUIRE(p != -1);
+                CHECK(dist[p] + g.getAdjacencyMatrix()[p][v] == dist[v]);
+            }
+        }
+    };
+
+    SUBCASE("Same distances as Bellman-Ford")
+    {
+        ariel::Graph grid;
+        ariel::Graph sparse;
+        ariel::Graph powerLaw;
+        ariel::GraphGenerator gen(81, ariel::WeightRange{1, 20});
+        gen.grid(grid, 12, 12);
+        gen.erdosRenyi(sparse, 150, 0.03, true);
+        gen.powerLaw(powerLaw, 120, 2);
+        for (ariel::Graph* g : {&grid, &sparse, &powerLaw}) {
+            vector<int> expected = reference(*g, 0);
+            vector<int> dist;
+            vector<int> parent;
+            ariel::Algorithms::dijkstra(*g, 0, dist, parent);
+            CHECK(dist == expected);
+            checkTree(*g, 0, dist, parent);
+            for (int delta : {0, 1, 5, 1000}) {
+                ariel::Algorithms::deltaStepping(*g, 0, dist, parent, delta);
+                CHECK(dist == expected);
+                checkTree(*g, 0, dist, parent);
+            }
+        }
+    }
+
+    SUBCASE("Through shortestPath and shortestPaths")
+    {
+        ariel::Graph g;
+        vector<vector<int>> graph = {
+            {0, 4, 1, 0},
+            {0, 0, 0, 1},
+            {0, 2, 0, 6},
+            {0, 0, 0, 0}};
+        g.loadGraph(graph);
+        CHECK(ariel::Algorithms::shortestPath(g, 0, 3, ariel::ShortestPathEngine::Dijkstra) == "0->2->1->3");
+        CHECK(ariel::Algorithms::shortestPath(g, 0, 3, ariel::ShortestPathEngine::DeltaStepping) == "0->2->1->3");
+        CHECK(ariel::Algorithms::shortestPath(g, 3, 0, ariel::ShortestPathEngine::DeltaStepping) == "-1");
+        vector<string> batch = ariel::Algorithms::shortestPaths(g, {{0, 3}, {2, 3}}, ariel::ShortestPathEngine::DeltaStepping);
+        CHECK(batch == vector<string>({"0->2->1->3", "2->1->3"}));
+    }
+
+    SUBCASE("Negative edges and bad arguments")
+    {
+        ariel::Graph g;
+        vector<vector<int>> graph = {
+            {0, -1},
+            {0, 0}};
+        g.loadGraph(graph);
+        vector<int> dist;
+        vector<int> parent;
+        CHECK_THROWS_AS(ariel::Algorithms::dijkstra(g, 0, dist, parent), std::invalid_argument);
+        CHECK_THROWS_AS(ariel::Algorithms::deltaStepping(g, 0, dist, parent), std::invalid_argument);
+        g.setEdge(0, 1, 1);
+        CHECK_THROWS_AS(ariel::Algorithms::dijkstra(g, 2, dist, parent), std::out_of_range);
+        ariel::Algorithms::deltaStepping(g, 0, dist, parent);
+        CHECK(dist == vector<int>({0, 1}));
+    }
+
+    SUBCASE("autoDelta")
+    {
+        ariel::Graph g;
+        g.loadEmpty(4);
+        CHECK(ariel::Algorithms::autoDelta(g) == 1);
+        g.setEdge(0, 1, 40);
+        g.setEdge(1, 2, 8);
+        g.setEdge(2, 3, 8);
+        g.setEdge(3, 0, 8);
+        // heaviest edge 40, average degree 1
+        CHECK(ariel::Algorithms::autoDelta(g) == 40);
+    }
+}
+
+TEST_CASE("Test vertex attributes and A*")
+{
+    SUBCASE("Attributes follow the vertices")
+    {
+        ariel::Graph g;
+        g.loadEmpty(3);
+        CHECK(g.hasAttribute("x") == false);
+        CHECK_THROWS_AS(g.attribute("x"), std::out_of_range);
+        g.setAttribute("x", 1, 2.5);
+        CHECK(g.attribute("x") == vector<double>({0, 2.5, 0}));
+        CHECK_THROWS_AS(g.setAttribute("x", 3, 1), std::out_of_range);
+        CHECK_THROWS_AS(g.setAttributes("y", {1, 2}), std::invalid_argument);
+        g.setAttributes("y", {1, 2, 3});
+        g.addNode();
+        CHECK(g.attribute("x") == vector<double>({0, 2.5, 0, 0}));
+        g.removeNode();
+        g.removeNode();
+        CHECK(g.attribute("y") == vector<double>({1, 2}));
+        g.removeAttribute("y");
+        CHECK(g.hasAttribute("y") == false);
+        g.loadEmpty(2);
+        CHECK(g.hasAttribute("x") == false);
+    }
+
+    SUBCASE("Same distance as Dijkstra on a grid, with fewer vertices")
+    {
+        ariel::Graph g;
+        ariel::GraphGenerator gen(33, ariel::WeightRange{1, 9});
+        gen.grid(g, 30, 30);
+        CHECK(g.attribute("x")[31] == 1);
+        CHECK(g.attribute("y")[31] == 1);
+        vector<int> dist;
+        vector<int> parent;
+        int end = 30 * 15 + 20;
+        ariel::Algorithms::dijkstra(g, 0, dist, parent);
+        for (ariel::Heuristic kind : {ariel::Heuristic::Euclidean, ariel::Heuristic::Manhattan}) {
+            ariel::PathResult r = ariel::Algorithms::aStarSearch(g, 0, end,
+                ariel::Algorithms::coordinateHeuristic(g.attribute("x"), g.attribute("y"), end, kind));
+            CHECK(r.distance == dist[end]);
+            REQUIRE(r.path.size() > 1);
+            CHECK(r.path.front() == 0);
+            CHECK(r.path.back() == end);
+            int length = 0;
+            for (size_t k = 0; k + 1 < r.path.size(); k++) {
+                length += g.getAdjacencyMatrix()[r.path[k]][r.path[k + 1]];
+            }
+            CHECK(length == r.distance);
+            CHECK(r.settled < 900);
+        }
+        // with unit weights Manhattan is exact and only the vertices of shortest paths come out
+        ariel::GraphGenerator unit(33);
+        unit.grid(g, 30, 30);
+        ariel::PathResult r = ariel::Algorithms::aStarSearch(g, 0, 29,
+            ariel::Algorithms::coordinateHeuristic(g.attribute("x"), g.attribute("y"), 29, ariel::Heuristic::Manhattan));
+        CHECK(r.distance == 29);
+        CHECK(r.settled <= 60);
+        CHECK(ariel::Algorithms::aStar(g, 0, 2, ariel::Heuristic::Manhattan) == "0->1->2");
+    }
+
+    SUBCASE("Callback heuristic")
+    {
+        ariel::Graph g;
+        vector<vector<int>> graph = {
+            {0, 4, 1, 0},
+            {0, 0, 0, 1},
+            {0, 2, 0, 6},
+            {0, 0, 0, 0}};
+        g.loadGraph(graph);
+        auto zero = [](int) { return 0.0; };
+        CHECK(ariel::Algorithms::aStar(g, 0, 3, zero) == "0->2->1->3");
+        CHECK(ariel::Algorithms::aStar(g, 3, 0, zero) == "-1");
+        CHECK(ariel::Algorithms::aStarSearch(g, 3, 0, zero).path.empty());
+        CHECK(ariel::Algorithms::aStarSearch(g, 0, 0, zero).distance == 0);
+        // no coordinates on this graph
+        CHECK_THROWS_AS(ariel::Algorithms::aStar(g, 0, 3, ariel::Heuristic::Euclidean), std::out_of_range);
+        CHECK_THROWS_AS(ariel::Algorithms::aStar(g, 0, 4, zero), std::out_of_range);
+        g.setEdge(0, 1, -4);
+        CHECK_THROWS_AS(ariel::Algorithms::aStar(g, 0, 3, zero), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Test landmark index")
+{
+    const int INF = numeric_limits<int>::max();
+
+    SUBCASE("The bounds never exceed the distances")
+    {
+        ariel::Graph undirected;
+        ariel::Graph directed;
+        ariel::GraphGenerator gen(5, ariel::WeightRange{1, 30});
+        gen.grid(undirected, 8, 8);
+        gen.erdosRenyi(directed, 60, 0.05, true);
+        for (ariel::Graph* g : {&undirected, &directed}) {
+            for (ariel::LandmarkStrategy strategy : {ariel::LandmarkStrategy::Farthest, ariel::LandmarkStrategy::Avoid}) {
+                ariel::LandmarkIndex index(*g, 4, strategy);
+                CHECK(index.size() == 4);
+                vector<int> landmarks = index.getLandmarks();
+                sort(landmarks.begin(), landmarks.end());
+                CHECK(unique(landmarks.begin(), landmarks.end()) == landmarks.end());
+                int n = g->getAdjacencyMatrix().size();
+                bool exact = true;
+                for (int v = 0; v < n; v++) {
+                    vector<int> dist;
+                    vector<int> parent;
+                    ariel::Algorithms::dijkstra(*g, v, dist, parent);
+                    for (int t = 0; t < n; t++) {
+                        exact = exact && index.lowerBound(v, t) <= dist[t];
+                    }
+                }
+                CHECK(exact);
+            }
+        }
+    }
+
+    SUBCASE("Queries match Dijkstra and settle fewer vertices")
+    {
+        ariel::Graph g;
+        ariel::GraphGenerator gen(17, ariel::WeightRange{1, 20});
+        gen.grid(g, 25, 25);
+        ariel::LandmarkIndex index(g, 8);
+        size_t altSettled = 0;
+        size_t plainSettled = 0;
+        int n = g.getAdjacencyMatrix().size();
+        for (int q = 0; q < 20; q++) {
+            int start = gen.uniform(n);
+            int end = gen.uniform(n);
+            vector<int> dist;
+            vector<int> parent;
+            ariel::Algorithms::dijkstra(g, start, dist, parent);
+            ariel::PathResult alt = index.query(g, start, end);
+            CHECK(alt.distance == dist[end]);
+            CHECK(alt.path.front() == start);
+            CHECK(alt.path.back() == end);
+            altSettled += alt.settled;
+            plainSettled += ariel::Algorithms::aStarSearch(g, start, end, [](int) { return 0.0; }).settled;
+        }
+        CHECK(altSettled * 3 < plainSettled);
+
+        string path = ariel::Algorithms::shortestPath(g, 0, n - 1, index);
+        vector<int> dist;
+        vector<int> parent;
+        ariel::Algorithms::dijkstra(g, 0, dist, parent);
+        CHECK(path.substr(0, 3) == "0->");
+        CHECK(index.query(g, 0, n - 1, 1).distance == dist[n - 1]);
+    }
+
+    SUBCASE("Unreachable targets")
+    {
+        ariel::Graph g;
+        vector<vector<int>> graph = {
+            {0, 2, 0, 0},
+            {0, 0, 3, 0},
+            {0, 0, 0, 0},
+            {0, 0, 1, 0}};
+        g.loadGraph(graph);
+        ariel::LandmarkIndex index(g, 2, ariel::LandmarkStrategy::Farthest);
+        CHECK(index.lowerBound(2, 0) == INF);
+        CHECK(ariel::Algorithms::shortestPath(g, 0, 2, index) == "0->1->2");
+        CHECK(ariel::Algorithms::shortestPath(g, 2, 0, index) == "-1");
+        CHECK(ariel::Algorithms::shortestPath(g, 3, 1, index) == "-1");
+        CHECK(index.query(g, 3, 3).distance == 0);
+    }
+
+    SUBCASE("Save and load")
+    {
+        ariel::Graph g;
+        ariel::GraphGenerator gen(23, ariel::WeightRange{1, 9});
+        gen.erdosRenyi(g, 40, 0.1, true);
+        ariel::LandmarkIndex index(g, 3);
+        stringstream file;
+        index.save(file);
+        ariel::LandmarkIndex loaded = ariel::LandmarkIndex::load(file, g);
+        CHECK(loaded.getLandmarks() == index.getLandmarks());
+        bool same = true;
+        for (int v = 0; v < 40; v++) {
+            for (int t = 0; t < 40; t++) {
+                same = same && loaded.lowerBound(v, t) == index.lowerBound(v, t);
+            }
+        }
+        CHECK(same);
+
+        // another graph, a cut file and something that is not an index
+        ariel::Graph other;
+        gen.erdosRenyi(other, 40, 0.1, true);
+        stringstream again;
+        index.save(again);
+        CHECK_THROWS_AS(ariel::LandmarkIndex::load(again, other), std::runtime_error);
+        stringstream whole;
+        index.save(whole);
+        string data = whole.str();
+        stringstream truncated(data.substr(0, data.size() / 2));
+        CHECK_THROWS_AS(ariel::LandmarkIndex::load(truncated, g), std::runtime_error);
+        stringstream garbage("not an index at all");
+        CHECK_THROWS_AS(ariel::LandmarkIndex::load(garbage, g), std::runtime_error);
+    }
+
+    SUBCASE("Bad arguments and a changed graph")
+    {
+        ariel::Graph g;
+        CHECK_THROWS_AS(ariel::LandmarkIndex(g, 2), std::invalid_argument);
+        g.loadEmpty(3);
+        g.setEdge(0, 1, 1);
+        CHECK_THROWS_AS(ariel::LandmarkIndex(g, 0), std::invalid_argument);
+        ariel::LandmarkIndex index(g, 10);
+        CHECK(index.size() == 3);
+        CHECK_THROWS_AS(index.query(g, 0, 3), std::out_of_range);
+        g.setEdge(1, 2, 1);
+        CHECK_THROWS_AS(index.query(g, 0, 2), std::logic_error);
+        // a new weight with the same vertices and edges changes the distances too
+        ariel::LandmarkIndex rebuilt(g, 2);
+        ariel::Graph copy = g;
+        CHECK(rebuilt.query(copy, 0, 2).distance == 2);
+        g.setEdge(1, 2, 5);
+        CHECK_THROWS_AS(rebuilt.query(g, 0, 2), std::logic_error);
+        CHECK_THROWS_AS(ariel::Algorithms::shortestPath(g, 0, 2, rebuilt), std::logic_error);
+        CHECK(ariel::LandmarkIndex(g, 2).query(g, 0, 2).distance == 6);
+        CHECK(copy.getRevision() != g.getRevision());
+        g.setEdge(0, 2, -1);
+        CHECK_THROWS_AS(ariel::LandmarkIndex(g, 2), std::invalid_argument);
+    }
+}
+
+#ifdef ARIEL_ENABLE_STATS
+TEST_CASE("Test stats counters on the thread pool")
+{
+    ariel::Graph g;
+    ariel::GraphGenerator gen(3);
+    gen.erdosRenyi(g, 300, 0.05, false);
+    vector<int> sources(64);
+    for (int i = 0; i < 64; i++) {
+        sources[i] = i;
+    }
+    ariel::Algorithms::hopDistances(g, sources);
+    ariel::AlgorithmStats one = ariel::StatsRegistry::last();
+    CHECK(one.edgesScanned > 0);
+
+    // four batches of the same sources run as separate tasks and must all be counted in the call
+    vector<int> four;
+    for (int copy = 0; copy < 4; copy++) {
+        four.insert(four.end(), sources.begin(), sources.end());
+    }
+    ariel::StatsRegistry::clear();
+    ariel::Algorithms::hopDistances(g, four);
+    ariel::AlgorithmStats all = ariel::StatsRegistry::last();
+    CHECK(all.edgesScanned == 4 * one.edgesScanned);
+    CHECK(all.verticesVisited == 4 * one.verticesVisited);
+    map<string, ariel::AggregateStats> calls = ariel::StatsRegistry::aggregate();
+    CHECK(calls.size() == 1);
+    CHECK(calls["hopDistances"].calls == 1);
+
+    // a call inside a task is a call of its own, and its work is counted in the outer call too
+    ariel::StatsRegistry::clear();
+    {
+        ariel::ScopedStats outer("outer");
+        ariel::TaskGroup group;
+        for (int t = 0; t < 8; t++) {
+            group.run([&]() { ariel::Algorithms::hopDistances(g, sources); });
+        }
+        group.wait();
+    }
+    calls = ariel::StatsRegistry::aggregate();
+    CHECK(calls["hopDistances"].calls == 8);
+    CHECK(calls["outer"].calls == 1);
+    CHECK(calls["outer"].total.edgesScanned == 8 * one.edgesScanned);
+}
+#endif
@@ -0,0 +1,238 @@
+// Mail: tzohary1234@gmail.com
+// Author: Tzohar Lary
+
+#include "ThreadPool.hpp"
+#include <cstdlib>
+#include <stdexcept>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace std;
+using namespace ariel;
+
+// index of the worker that runs on this thread, -1 outside the pool
+static thread_local int currentWorker = -1;
+static thread_local ThreadPool* currentPool = nullptr;
+
+// instance() creates the pool once with call_once, after that a call is only a check of the flag.
+// configure() takes the mutex to see whether the pool was already made.
+static once_flag sharedOnce;
+static mutex instanceMutex;
+static unique_ptr<ThreadPool> sharedPool;
+static size_t configuredThreads = 0;
+static bool configuredPin = false;
+
+ThreadPool::ThreadPool(size_t threads, bool pin) : stopping(false), pending(0), nextWorker(0) {
+    if (threads == 0) {
+        threads = max(1u, thread::hardware_concurrency());
+    }
+    for (size_t i = 0; i < threads; ++i) {
+        workers.push_back(unique_ptr<Worker>(new Worker()));
+    }
+    for (size_t i = 0; i < threads; ++i) {
+        this->threads.push_back(thread(&ThreadPool::workerLoop, this, (int)i, pin));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (thread& t : threads) {
+        t.join();
+    }
+}
+
+ThreadPool& ThreadPool::instance() {
+    call_once(sharedOnce, []() {
+        lock_guard<mutex> lock(instanceMutex);
+        size_t threads = configuredThreads;
+        const char* env = getenv("ARIEL_THREADS");
+        if (threads == 0 && env != nullptr) {
+            threads = max(0, atoi(env));
+        }
+        sharedPool.reset(new ThreadPool(threads, configuredPin));
+    });
+    return *sharedPool;
+}
+
+void ThreadPool::configure(size_t threads, bool pin) {
+    lock_guard<mutex> lock(instanceMutex);
+    if (sharedPool) {
+        throw logic_error("The thread pool is already running");
+    }
+    configuredThreads = threads;
+    configuredPin = pin;
+}
+
+size_t ThreadPool::size() const {
+    return workers.size();
+}
+
+void ThreadPool::submit(function<void()> task) {
+    // a worker keeps its own tasks, a thread outside the pool spreads them
+    int target = currentPool == this ? currentWorker : (int)(nextWorker++ % workers.size());
+    {
+        lock_guard<mutex> lock(workers[target]->mutex);
+        workers[target]->tasks.push_back(move(task));
+    }
+    ++pending;
+    {
+        // taking the lock makes sure a worker that is going to sleep sees the new task
+        lock_guard<mutex> lock(sleepMutex);
+    }
+    wake.notify_one();
+}
+
+bool ThreadPool::takeTask(int self, function<void()>& task) {
+    if (pending == 0) {
+        return false;
+    }
+    size_t n = workers.size();
+    // first the own deque from the back, then steal from the front of the others
+    if (self >= 0) {
+        Worker& own = *workers[self];
+        lock_guard<mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = move(own.tasks.back());
+            own.tasks.pop_back();
+            --pending;
+            return true;
+        }
+    }
+    size_t start = self >= 0 ? self + 1 : 0;
+    for (size_t k = 0; k < n; ++k) {
+        Worker& victim = *workers[(start + k) % n];
+        lock_guard<mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = move(victim.tasks.front());
+            victim.tasks.pop_front();
+            --pending;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::runOne() {
+    function<void()> task;
+    if (!takeTask(currentPool == this ? currentWorker : -1, task)) {
+        return false;
+    }
+    task();
+    return true;
+}
+
+void ThreadPool::workerLoop(int self, bool pin) {
+    currentWorker = self;
+    currentPool = this;
+#ifdef __linux__
+    if (pin) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(self % CPU_SETSIZE, &cpus);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    }
+#else
+    (void)pin; // pinning is supported on Linux only
+#endif
+    function<void()> task;
+    while (true) {
+        if (takeTask(self, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+        unique_lock<mutex> lock(sleepMutex);
+        wake.wait(lock, [this]() { return stopping || pending > 0; });
+        if (stopping && pending == 0) {
+            return;
+        }
+    }
+}
+
+void ThreadPool::parallelFor(size_t begin, size_t end, size_t grain, const function<void(size_t, size_t)>& body) {
+    if (grain == 0) {
+        grain = 1;
+    }
+    if (end <= begin) {
+        return;
+    }
+    if (end - begin <= grain || workers.size() <= 1) {
+        body(begin, end); // not worth a task
+        return;
+    }
+    TaskGroup group(*this);
+    // the calling thread keeps the first piece for itself
+    for (size_t lo = begin + grain; lo < end; lo += grain) {
+        size_t hi = min(end, lo + grain);
+        group.run([&body, lo, hi]() { body(lo, hi); });
+    }
+    try {
+        body(begin, min(end, begin + grain));
+    } catch (...) {
+        group.wait();
+        throw;
+    }
+    group.wait();
+}
+
+TaskGroup::TaskGroup(ThreadPool& pool) : pool(pool), remaining(0) {
+}
+
+TaskGroup::~TaskGroup() {
+    // the tasks may still use the group, so it can't be gone before them
+    try {
+        wait();
+    } catch (...) {
+    }
+}
+
+void TaskGroup::run(const function<void()>& task) {
+    ++remaining;
+    pool.submit([this, task]() {
+#ifdef ARIEL_ENABLE_STATS
+        TaskStats taskStats;
+#endif
+        try {
+            task();
+        } catch (...) {
+            lock_guard<mutex> lock(errorMutex);
+            if (!error) {
+                error = current_exception();
+            }
+        }
+        // The last task wakes wait() under the lock, so the group can't be destroyed before
+        // the task is done with it
+        lock_guard<mutex> lock(errorMutex);
+#ifdef ARIEL_ENABLE_STATS
+        stats += taskStats.collected();
+#endif
+        if (--remaining == 0) {
+            done.notify_all();
+        }
+    });
+}
+
+void TaskGroup::wait() {
+    // help with the waiting tasks, and when there are none left the rest of the group is
+    // running on other threads, so sleep until the last of them is done
+    while (remaining > 0 && pool.runOne()) {
+    }
+    unique_lock<mutex> lock(errorMutex);
+    done.wait(lock, [this]() { return remaining == 0; });
+#ifdef ARIEL_ENABLE_STATS
+    // the waiting thread is the one whose call submitted the tasks
+    StatsRegistry::current() += stats;
+    stats = AlgorithmStats();
+#endif
+    if (error) {
+        exception_ptr e = error;
+        error = nullptr;
+        rethrow_exception(e);
+    }
+}
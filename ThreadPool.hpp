@@ -0,0 +1,91 @@
+// Mail: tzohary1234@gmail.com
+// Author: Tzohar Lary
+
+
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "AlgorithmStats.hpp"
+
+namespace ariel {
+    // Work-stealing thread pool shared by all the parallel algorithms.
+    // Every worker has its own deque: it takes its own tasks from the back (the newest,
+    // still in cache) and an idle worker steals from the front of the others (the oldest,
+    // usually the biggest pieces of work). Tasks submitted from outside the pool are
+    // spread over the workers in turn.
+    class ThreadPool {
+        private:
+            struct Worker {
+                std::deque<std::function<void()>> tasks;
+                std::mutex mutex;
+            };
+
+            std::vector<std::unique_ptr<Worker>> workers;
+            std::vector<std::thread> threads;
+            std::atomic<bool> stopping;
+            std::atomic<size_t> pending;   // tasks in all the deques
+            std::atomic<size_t> nextWorker; // round robin for tasks from outside the pool
+            std::mutex sleepMutex;
+            std::condition_variable wake;
+
+            bool takeTask(int self, std::function<void()>& task);
+            void workerLoop(int self, bool pin);
+
+        public:
+            // threads == 0 uses one thread per hardware thread. With pin, worker i runs only on CPU i.
+            explicit ThreadPool(size_t threads = 0, bool pin = false);
+            ~ThreadPool();
+            ThreadPool(const ThreadPool&) = delete;
+            ThreadPool& operator=(const ThreadPool&) = delete;
+
+            // The pool of the library. Its size comes from configure(), or the ARIEL_THREADS
+            // environment variable, or the number of hardware threads.
+            static ThreadPool& instance();
+            // Must be called before the first use of instance(), throws logic_error after it.
+            static void configure(size_t threads, bool pin);
+
+            size_t size() const;
+            void submit(std::function<void()> task);
+            // Runs one waiting task on the calling thread, returns false if there was none.
+            bool runOne();
+            // Calls body(lo, hi) on pieces of [begin, end) of at least grain indices, in parallel,
+            // and returns when all of them are done. The calling thread works too.
+            void parallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& body);
+    };
+
+    // A set of tasks that can be waited for together. While waiting, the thread runs waiting
+    // tasks of the pool itself, so groups can be nested inside tasks without deadlock, and
+    // when there are none it sleeps until the last task of the group is done.
+    // The first exception thrown by a task is thrown again by wait().
+    // With ARIEL_ENABLE_STATS the work the tasks count is added to the call that waits for them.
+    class TaskGroup {
+        private:
+            ThreadPool& pool;
+            std::atomic<size_t> remaining;
+            std::exception_ptr error;
+            std::mutex errorMutex;   // also guards stats and the last decrement of remaining
+            std::condition_variable done; // notified when remaining gets to 0
+            AlgorithmStats stats;    // counted by the finished tasks, not yet added by wait()
+
+        public:
+            explicit TaskGroup(ThreadPool& pool = ThreadPool::instance());
+            ~TaskGroup();
+            TaskGroup(const TaskGroup&) = delete;
+            TaskGroup& operator=(const TaskGroup&) = delete;
+
+            void run(const std::function<void()>& task);
+            void wait();
+    };
+}
+
+#endif // THREADPOOL_HPP
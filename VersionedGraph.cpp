@@ -0,0 +1,49 @@
+// Mail: tzohary1234@gmail.com
+// Author: Tzohar Lary
+
+#include "VersionedGraph.hpp"
+
+using namespace std;
+using namespace ariel;
+
+VersionedGraph::VersionedGraph() : current(make_shared<const Graph>()), currentVersion(0) {
+}
+
+VersionedGraph::VersionedGraph(const Graph& g) : current(make_shared<const Graph>(g)), currentVersion(0) {
+}
+
+shared_ptr<const Graph> VersionedGraph::snapshot() const {
+    return atomic_load(&current);
+}
+
+unsigned long long VersionedGraph::version() const {
+    return currentVersion.load();
+}
+
+void VersionedGraph::publish(const Graph& next) {
+    lock_guard<mutex> lock(writerMutex);
+    atomic_store(&current, shared_ptr<const Graph>(make_shared<const Graph>(next)));
+    ++currentVersion;
+}
+
+void VersionedGraph::update(const function<void(Graph&)>& change) {
+    lock_guard<mutex> lock(writerMutex);
+    // the change is made on a private copy, readers keep using the published version meanwhile.
+    // If it throws, nothing is published.
+    shared_ptr<Graph> next = make_shared<Graph>(*atomic_load(&current));
+    change(*next);
+    atomic_store(&current, shared_ptr<const Graph>(next));
+    ++currentVersion;
+}
+
+void VersionedGraph::setEdge(int i, int j, int val) {
+    update([i, j, val](Graph& g) { g.setEdge(i, j, val); });
+}
+
+void VersionedGraph::setEdges(const vector<EdgeChange>& changes) {
+    update([&changes](Graph& g) {
+        for (const EdgeChange& c : changes) {
+            g.setEdge(c.i, c.j, c.val);
+        }
+    });
+}
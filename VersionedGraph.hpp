@@ -0,0 +1,55 @@
+// Mail: tzohary1234@gmail.com
+// Author: Tzohar Lary
+
+
+#ifndef VERSIONEDGRAPH_HPP
+#define VERSIONEDGRAPH_HPP
+
+#include "Graph.hpp"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ariel {
+    // One cell of the matrix for VersionedGraph::setEdges
+    struct EdgeChange {
+        int i;
+        int j;
+        int val;
+    };
+
+
+    // A graph shared between many reader threads and one writer at a time (copy-on-write).
+    // A reader pins the current version with snapshot() and can run any algorithm on it
+    // without locks, the version it holds never changes. The writer changes a private copy
+    // and publishes it with one atomic pointer store, so readers see either the old or the
+    // new version, never a half updated one. An old version is freed when its last reader
+    // drops its snapshot.
+    // Every update copies the whole graph (the matrix and the adjacency lists, O(n^2)), so changes
+    // that belong together should be made in one update, or with setEdges, which copies once for
+    // all of them and publishes them as one version. setEdge is for a single change.
+    class VersionedGraph {
+        private:
+            std::shared_ptr<const Graph> current; // only read and written with atomic_load / atomic_store
+            std::atomic<unsigned long long> currentVersion;
+            std::mutex writerMutex; // writers are serialized, readers never take it
+
+        public:
+            VersionedGraph();
+            explicit VersionedGraph(const Graph& g);
+            VersionedGraph(const VersionedGraph&) = delete;
+            VersionedGraph& operator=(const VersionedGraph&) = delete;
+
+            std::shared_ptr<const Graph> snapshot() const;
+            unsigned long long version() const;
+            void publish(const Graph& next);
+            void update(const std::function<void(Graph&)>& change);
+            void setEdge(int i, int j, int val);
+            // All the changes in order, on one copy, published as one version
+            void setEdges(const std::vector<EdgeChange>& changes);
+    };
+}
+
+#endif // VERSIONEDGRAPH_HPP
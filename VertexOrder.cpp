@@ -0,0 +1,223 @@
+// Mail: tzohary1234@gmail.com
+// Author: Tzohar Lary
+
+#include "VertexOrder.hpp"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+using namespace ariel;
+
+// Calls visit(v) once for every vertex v != u with an edge u->v or v->u, in increasing order of v.
+// The out-edges and the in-edges are both sorted, so they are merged like two sorted lists.
+template <typename Visit>
+static void forEachUndirectedNeighbor(const Graph& g, int u, Visit visit) {
+    NeighborRange out = g.neighbors(u);
+    NeighborRange in = g.inNeighbors(u);
+    size_t i = 0;
+    size_t j = 0;
+    while (i < out.size() || j < in.size()) {
+        int v;
+        if (j == in.size() || (i < out.size() && out[i].vertex < in[j].vertex)) {
+            v = out[i++].vertex;
+        } else if (i == out.size() || in[j].vertex < out[i].vertex) {
+            v = in[j++].vertex;
+        } else {
+            v = out[i++].vertex; // an edge in both directions
+            ++j;
+        }
+        if (v != u) {
+            visit(v);
+        }
+    }
+}
+
+// Number of vertices connected to v in any direction
+static vector<int> undirectedDegrees(const Graph& g) {
+    size_t n = g.getAdjacencyMatrix().size();
+    vector<int> degree(n, 0);
+    for (size_t u = 0; u < n; ++u) {
+        forEachUndirectedNeighbor(g, u, [&](int) { ++degree[u]; });
+    }
+    return degree;
+}
+
+Permutation VertexOrder::fromOrder(const vector<int>& newToOld) {
+    Permutation p;
+    p.newToOld = newToOld;
+    p.oldToNew.assign(newToOld.size(), -1);
+    for (size_t i = 0; i < newToOld.size(); ++i) {
+        int old = newToOld[i];
+        if (old < 0 || old >= (int)newToOld.size() || p.oldToNew[old] != -1) {
+            throw invalid_argument("Not a permutation");
+        }
+        p.oldToNew[old] = i;
+    }
+    return p;
+}
+
+Permutation VertexOrder::reverseCuthillMcKee(const Graph& g) {
+    int n = g.getAdjacencyMatrix().size();
+    vector<int> degree = undirectedDegrees(g);
+
+    // every component starts from its lowest degree vertex
+    vector<int> byDegree(n);
+    for (int v = 0; v < n; ++v) {
+        byDegree[v] = v;
+    }
+    stable_sort(byDegree.begin(), byDegree.end(), [&degree](int a, int b) { return degree[a] < degree[b]; });
+
+    vector<int> order;
+    vector<bool> placed(n, false);
+    vector<int> neighbors;
+    for (int root : byDegree) {
+        if (placed[root]) continue;
+        placed[root] = true;
+        order.push_back(root);
+        for (size_t head = order.size() - 1; head < order.size(); ++head) {
+            int u = order[head];
+            neighbors.clear();
+            forEachUndirectedNeighbor(g, u, [&](int v) {
+                if (!placed[v]) {
+                    neighbors.push_back(v);
+                }
+            });
+            stable_sort(neighbors.begin(), neighbors.end(), [&degree](int a, int b) { return degree[a] < degree[b]; });
+            for (int v : neighbors) {
+                placed[v] = true;
+                order.push_back(v);
+            }
+        }
+    }
+    reverse(order.begin(), order.end());
+    return fromOrder(order);
+}
+
+Permutation VertexOrder::degreeSorted(const Graph& g) {
+    vector<int> degree = undirectedDegrees(g);
+    vector<int> order(degree.size());
+    for (size_t v = 0; v < order.size(); ++v) {
+        order[v] = v;
+    }
+    stable_sort(order.begin(), order.end(), [&degree](int a, int b) { return degree[a] > degree[b]; });
+    return fromOrder(order);
+}
+
+Graph VertexOrder::apply(const Graph& g, const Permutation& p) {
+    const vector<vector<int>>& adj = g.getAdjacencyMatrix();
+    size_t n = adj.size();
+    if (p.newToOld.size() != n) {
+        throw invalid_argument("The permutation doesn't match the graph");
+    }
+    vector<vector<int>> matrix(n, vector<int>(n, 0));
+    for (size_t i = 0; i < n; ++i) {
+        const vector<int>& row = adj[p.newToOld[i]];
+        for (size_t j = 0; j < n; ++j) {
+            matrix[i][j] = row[p.newToOld[j]];
+        }
+    }
+    Graph reordered;
+    reordered.loadGraph(matrix);
+    // loadGraph starts without attributes, the values of every vertex move with it
+    for (const string& name : g.attributeNames()) {
+        const vector<double>& values = g.attribute(name);
+        vector<double> moved(n);
+        for (size_t i = 0; i < n; ++i) {
+            moved[i] = values[p.newToOld[i]];
+        }
+        reordered.setAttributes(name, moved);
+    }
+    return reordered;
+}
+
+ReorderedGraph::ReorderedGraph(const Graph& original, const Permutation& p)
+    : graph(VertexOrder::apply(original, p)), permutation(p) {
+}
+
+const Graph& ReorderedGraph::getGraph() const {
+    return graph;
+}
+
+const Permutation& ReorderedGraph::getPermutation() const {
+    return permutation;
+}
+
+int ReorderedGraph::toInternal(int v) const {
+    if (v < 0 || v >= (int)permutation.oldToNew.size()) {
+        throw invalid_argument("Node does not exist");
+    }
+    return permutation.oldToNew[v];
+}
+
+int ReorderedGraph::toExternal(int v) const {
+    if (v < 0 || v >= (int)permutation.newToOld.size()) {
+        throw invalid_argument("Node does not exist");
+    }
+    return permutation.newToOld[v];
+}
+
+string ReorderedGraph::shortestPath(int start, int end, ShortestPathEngine engine) const {
+    int internalEnd = toInternal(end);
+    vector<int> dist;
+    vector<int> prev;
+    Algorithms::singleSourcePaths(graph, toInternal(start), Algorithms::isDirected(graph), engine, dist, prev);
+    if (dist[internalEnd] == numeric_limits<int>::max()) {
+        return "-1"; // No path found
+    }
+    // the predecessor array in the original numbers
+    vector<int> externalPrev(prev.size(), -1);
+    for (size_t v = 0; v < prev.size(); ++v) {
+        if (prev[v] != -1) {
+            externalPrev[toExternal(v)] = toExternal(prev[v]);
+        }
+    }
+    return Algorithms::pathToString(externalPrev, end);
+}
+
+vector<vector<int>> ReorderedGraph::hopDistances(const vector<int>& sources) const {
+    vector<int> internalSources;
+    for (int s : sources) {
+        internalSources.push_back(toInternal(s));
+    }
+    vector<vector<int>> internalHops = Algorithms::hopDistances(graph, internalSources);
+    vector<vector<int>> hops(sources.size(), vector<int>(permutation.newToOld.size()));
+    for (size_t i = 0; i < sources.size(); ++i) {
+        for (size_t v = 0; v < hops[i].size(); ++v) {
+            hops[i][toExternal(v)] = internalHops[i][v];
+        }
+    }
+    return hops;
+}
+
+bool ReorderedGraph::isConnected() const {
+    return Algorithms::isConnected(graph);
+}
+
+bool ReorderedGraph::isContainsCycle() const {
+    return Algorithms::isContainsCycle(graph);
+}
+
+string ReorderedGraph::isBipartite() const {
+    // The searches start in the original order, so every component gets the colors it gets in
+    // the original graph, and the sets are printed in the original numbers
+    vector<int> colors;
+    if (!Algorithms::bipartiteColors(graph, permutation.oldToNew, colors)) {
+        return "0";
+    }
+    vector<int> externalColors(colors.size());
+    for (size_t v = 0; v < colors.size(); ++v) {
+        externalColors[toExternal(v)] = colors[v];
+    }
+    return Algorithms::bipartiteToString(externalColors);
+}
+
+string ReorderedGraph::negativeCycle() const {
+    // the undirected check starts from the vertex that is 2 in the original numbers
+    int source = permutation.oldToNew.size() > 2 ? toInternal(2) : 2;
+    return Algorithms::negativeCycle(graph, source);
+}
+
+bool ReorderedGraph::sameComponent(int u, int v) const {
+    return graph.sameComponent(toInternal(u), toInternal(v));
+}
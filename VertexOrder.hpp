@@ -0,0 +1,60 @@
+// Mail: tzohary1234@gmail.com
+// Author: Tzohar Lary
+
+
+#ifndef VERTEXORDER_HPP
+#define VERTEXORDER_HPP
+
+#include "Graph.hpp"
+#include "Algorithms.hpp"
+#include <vector>
+#include <string>
+
+namespace ariel {
+    // A renumbering of the vertices: vertex v of the original graph is oldToNew[v] in the
+    // reordered graph, and newToOld is the inverse.
+    struct Permutation {
+        std::vector<int> newToOld;
+        std::vector<int> oldToNew;
+    };
+
+    // Orders that put vertices that are used together next to each other in memory,
+    // so the row scans of the algorithms hit the cache more often on large graphs.
+    class VertexOrder {
+        public:
+            // Reverse Cuthill-McKee: BFS from a low degree vertex, neighbors by increasing degree,
+            // then reversed. It keeps the edges close to the diagonal of the matrix.
+            static Permutation reverseCuthillMcKee(const Graph& g);
+            // Highest degree first, so the busiest rows are together.
+            static Permutation degreeSorted(const Graph& g);
+            static Permutation fromOrder(const std::vector<int>& newToOld);
+            static Graph apply(const Graph& g, const Permutation& p);
+    };
+
+    // A graph stored in a new order that still answers in the original vertex numbers.
+    // The queries take original numbers and the results are mapped back to them.
+    class ReorderedGraph {
+        private:
+            Graph graph;
+            Permutation permutation;
+
+        public:
+            ReorderedGraph(const Graph& original, const Permutation& p);
+            const Graph& getGraph() const;
+            const Permutation& getPermutation() const;
+            int toInternal(int v) const;
+            int toExternal(int v) const;
+
+            std::string shortestPath(int start, int end,
+                                     ShortestPathEngine engine = ShortestPathEngine::BellmanFord) const;
+            std::vector<std::vector<int>> hopDistances(const std::vector<int>& sources) const;
+            bool isConnected() const;
+            bool isContainsCycle() const;
+            // The same answers as Algorithms::isBipartite and negativeCycle on the original graph
+            std::string isBipartite() const;
+            std::string negativeCycle() const;
+            bool sameComponent(int u, int v) const;
+    };
+}
+
+#endif // VERTEXORDER_HPP
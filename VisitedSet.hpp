@@ -0,0 +1,67 @@
+// Mail: tzohary1234@gmail.com
+// Author: Tzohar Lary
+
+
+#ifndef VISITEDSET_HPP
+#define VISITEDSET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ariel {
+    // The visited marks of a graph traversal. Every vertex keeps the stamp of the traversal
+    // that visited it, and a vertex is visited when its stamp is the current epoch, so clear()
+    // starts a new traversal in O(1) instead of zeroing n flags.
+    // The stamps are plain uint32_t, which is faster to read than the bits of a vector<bool>.
+    class VisitedSet {
+        private:
+            std::vector<uint32_t> stamps;
+            uint32_t epoch = 1;
+
+        public:
+            VisitedSet() {}
+            explicit VisitedSet(size_t n) : stamps(n, 0) {}
+
+            // Resizes to n vertices, all of them unvisited
+            void reset(size_t n) {
+                stamps.assign(n, 0);
+                epoch = 1;
+            }
+
+            // Starts a traversal of n vertices. When the size didn't change the old stamps
+            // are kept and only the epoch moves.
+            void prepare(size_t n) {
+                if (stamps.size() != n) {
+                    reset(n);
+                } else {
+                    clear();
+                }
+            }
+
+            // Unmarks all the vertices
+            void clear() {
+                if (++epoch == 0) {
+                    // after 2^32 traversals the old stamps could look current again
+                    stamps.assign(stamps.size(), 0);
+                    epoch = 1;
+                }
+            }
+
+            size_t size() const { return stamps.size(); }
+            bool contains(size_t v) const { return stamps[v] == epoch; }
+            void mark(size_t v) { stamps[v] = epoch; }
+            void unmark(size_t v) { stamps[v] = 0; }
+
+            // Marks v and returns true if it wasn't visited before
+            bool visit(size_t v) {
+                if (stamps[v] == epoch) {
+                    return false;
+                }
+                stamps[v] = epoch;
+                return true;
+            }
+    };
+}
+
+#endif // VISITEDSET_HPP
@@ -0,0 +1,102 @@
+// Mail: tzohary1234@gmail.com
+// Author: Tzohar Lary
+
+
+#ifndef WORKSPACE_HPP
+#define WORKSPACE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace ariel {
+    // Scratch vectors of one type on one thread. A vector is never freed, it keeps its capacity
+    // for the next algorithm that takes it, so repeated queries don't allocate.
+    template <typename T>
+    struct ScratchPool {
+        std::vector<std::unique_ptr<std::vector<T>>> buffers;
+        size_t top = 0; // buffers below top are in use
+
+        static ScratchPool& local() {
+            static thread_local ScratchPool pool;
+            return pool;
+        }
+    };
+
+    // A frame of scratch vectors for one algorithm call (an arena of vectors).
+    // take() hands out vectors from the pools of the current thread, and when the frame
+    // goes out of scope all of them are given back at once, by resetting the top of the pools.
+    // Frames nest like the calls that make them.
+    // take(n, value) saves the allocation, not the initialization: it still writes all n
+    // elements, because the vectors are handed on to code that reads them as plain vectors.
+    // Marks that are cleared on every call should be a VisitedSet from reuse(), and the arrays
+    // of a search that touches few vertices an EpochArray from reuse(), which reset in O(1)
+    // by moving their epoch.
+    //
+    //     Workspace ws;
+    //     std::vector<int>& dist = ws.take<int>(n, INF);
+    class Workspace {
+        private:
+            static const size_t MAX_POOLS = 8;
+            size_t* tops[MAX_POOLS];
+            size_t marks[MAX_POOLS];
+            size_t used = 0;
+
+            void remember(size_t* top) {
+                for (size_t i = 0; i < used; ++i) {
+                    if (tops[i] == top) {
+                        return; // this frame already knows where the pool was
+                    }
+                }
+                if (used == MAX_POOLS) {
+                    throw std::logic_error("Too many scratch types in one workspace");
+                }
+                tops[used] = top;
+                marks[used] = *top;
+                ++used;
+            }
+
+        public:
+            Workspace() {}
+            ~Workspace() {
+                for (size_t i = 0; i < used; ++i) {
+                    *tops[i] = marks[i];
+                }
+            }
+            Workspace(const Workspace&) = delete;
+            Workspace& operator=(const Workspace&) = delete;
+
+            // A vector of n copies of value. Its memory is reused from earlier calls when possible,
+            // but filling it is O(n) on every call.
+            template <typename T>
+            std::vector<T>& take(size_t n, const T& value) {
+                ScratchPool<T>& pool = ScratchPool<T>::local();
+                remember(&pool.top);
+                if (pool.top == pool.buffers.size()) {
+                    pool.buffers.push_back(std::unique_ptr<std::vector<T>>(new std::vector<T>()));
+                }
+                std::vector<T>& buffer = *pool.buffers[pool.top++];
+                buffer.assign(n, value);
+                return buffer;
+            }
+
+            // An object of the pool that is handed out as the last call left it, for types
+            // like VisitedSet and EpochArray that know how to reset themselves cheaply.
+            template <typename T>
+            T& reuse() {
+                ScratchPool<T>& pool = ScratchPool<T>::local();
+                remember(&pool.top);
+                if (pool.top == pool.buffers.size()) {
+                    pool.buffers.push_back(std::unique_ptr<std::vector<T>>(new std::vector<T>(1)));
+                }
+                std::vector<T>& buffer = *pool.buffers[pool.top++];
+                if (buffer.empty()) {
+                    buffer.resize(1);
+                }
+                return buffer.front();
+            }
+    };
+}
+
+#endif // WORKSPACE_HPP